@@ -1,5 +1,7 @@
 #include "dialects/autodiff/autodiff.h"
 
+#include <algorithm>
+
 #include <thorin/config.h>
 #include <thorin/pass/pass.h>
 #include <thorin/pass/pipelinebuilder.h>
@@ -38,6 +40,45 @@ const Def* id_pullback(const Def* A) {
     return id_pb;
 }
 
+bool is_id_pullback(const Def* pb) {
+    if (auto lam = pb->isa_mut<Lam>(); lam && lam->is_set() && lam->num_vars() == 2) {
+        if (auto app = lam->body()->isa<App>()) return app->callee() == lam->var(1) && app->arg() == lam->var(0_s);
+    }
+    return false;
+}
+
+/// Composes the pullbacks `f ∘ g` like `compose_cn` but does not wrap identity pullbacks.
+/// Each composition otherwise introduces two continuations that survive as closures.
+/// As pullbacks are linear, the composition with a zero pullback is itself a zero pullback.
+const Def* compose_pullback(const Def* f, const Def* g) {
+    if (is_zero_pullback(f) || is_zero_pullback(g)) {
+        auto F = f->type()->as<Pi>();
+        auto G = g->type()->as<Pi>();
+        return zero_pullback(G->dom(2, 0), F->ret_dom());
+    }
+    if (is_id_pullback(f)) return g;
+    if (is_id_pullback(g)) return f;
+    return compose_cn(f, g);
+}
+
+/// Conservatively checks whether @p def is provably zero:
+/// `zero T`, a zero integer literal, or a tuple/pack thereof.
+bool is_zero(const Def* def) {
+    if (match<zero>(def)) return true;
+    if (auto lit = def->isa<Lit>()) return Idx::size(lit->type()) && lit->get() == 0;
+    if (auto tuple = def->isa<Tuple>()) return std::ranges::all_of(tuple->ops(), [](auto op) { return is_zero(op); });
+    if (auto pack = def->isa_imm<Pack>()) return is_zero(pack->body());
+    return false;
+}
+
+/// Checks whether @p pb is a pullback that unconditionally returns a provably zero tangent.
+bool is_zero_pullback(const Def* pb) {
+    if (auto lam = pb->isa_mut<Lam>(); lam && lam->is_set() && lam->num_vars() == 2) {
+        if (auto app = lam->body()->isa<App>()) return app->callee() == lam->var(1) && is_zero(app->arg());
+    }
+    return false;
+}
+
 const Def* zero_pullback(const Def* E, const Def* A) {
     auto& world    = A->world();
     auto A_tangent = tangent_type_fun(A);
@@ -15,6 +15,8 @@ const Def* tangent_type_fun(const Def*);
 ///@{
 const Def* zero_def(const Def* T);
 const Def* zero_pullback(const Def* E, const Def* A);
+bool is_zero(const Def*);
+bool is_zero_pullback(const Def*);
 ///@}
 
 /// @name %%autodiff.sum
@@ -26,6 +28,8 @@ const Def* op_sum(const Def* T, DefArray defs);
 ///@{
 const Pi* pullback_type(const Def* E, const Def* A);
 const Def* id_pullback(const Def*);
+bool is_id_pullback(const Def*);
+const Def* compose_pullback(const Def* f, const Def* g);
 const Pi* autodiff_type_fun_pi(const Pi*);
 const Def* autodiff_type_fun(const Def*);
 ///@}
@@ -149,6 +149,12 @@ Ref AutoDiffEval::augment_tuple(const Tuple* tup, Lam* f, Lam* f_diff) {
     //    sum (m,A)
     //      ((cps2ds e0*) (s#0), ..., (cps2ds em*) (s#m))
     // ```
+    // Components with a zero pullback do not contribute to the sum.
+    if (std::ranges::all_of(pbs, [](Ref pb) { return is_zero_pullback(pb); })) {
+        partial_pullback[aug_tup] = zero_pullback(tup->type(), f->dom(2, 0));
+        return aug_tup;
+    }
+
     auto pb_ty = pullback_type(tup->type(), f->dom(2, 0));
     auto pb    = world.mut_lam(pb_ty)->set("tup_pb");
     world.DLOG("Augmented tuple: {} : {}", aug_tup, aug_tup->type());
@@ -157,8 +163,10 @@ Ref AutoDiffEval::augment_tuple(const Tuple* tup, Lam* f, Lam* f_diff) {
 
     auto pb_tangent = pb->var(0_s)->set("tup_s");
 
-    DefArray tangents(pbs.size(),
-                      [&](nat_t i) { return world.app(direct::op_cps2ds_dep(pbs[i]), world.extract(pb_tangent, i)); });
+    std::vector<const Def*> tangents;
+    for (size_t i = 0, e = pbs.size(); i != e; ++i)
+        if (!is_zero_pullback(pbs[i]))
+            tangents.emplace_back(world.app(direct::op_cps2ds_dep(pbs[i]), world.extract(pb_tangent, i)));
     pb->app(true, pb->var(1),
             // summed up tangents
             op_sum(tangent_type_fun(f->dom(2, 0)), tangents));
@@ -270,7 +278,7 @@ Ref AutoDiffEval::augment_app(const App* app, Lam* f, Lam* f_diff) {
         // `arg_pb: arg_tan -> fun_tan`
         world.DLOG("function pullback: {} : {}", fun_pb, fun_pb->type());
         world.DLOG("argument pullback: {} : {}", arg_pb, arg_pb->type());
-        auto res_pb = compose_cn(arg_pb, fun_pb);
+        auto res_pb = compose_pullback(arg_pb, fun_pb);
         world.DLOG("result pullback: {} : {}", res_pb, res_pb->type());
         partial_pullback[aug_res] = res_pb;
         world.debug_dump();
@@ -306,7 +314,7 @@ Ref AutoDiffEval::augment_app(const App* app, Lam* f, Lam* f_diff) {
         auto c1   = world.mut_lam(c1_ty)->set("c1");
         auto res  = c1->var((nat_t)0);
         auto r_pb = c1->var(1);
-        c1->app(true, aug_cont, {res, compose_cn(e_pb, r_pb)});
+        c1->app(true, aug_cont, {res, compose_pullback(e_pb, r_pb)});
 
         auto aug_app = world.app(aug_callee, {real_aug_args, c1});
         world.DLOG("aug_app: {} : {}", aug_app, aug_app->type());
@@ -317,6 +325,42 @@ Ref AutoDiffEval::augment_app(const App* app, Lam* f, Lam* f_diff) {
     assert(false && "should not be reached");
 }
 
+Ref AutoDiffEval::augment_checkpoint(const App* ckpt, Lam* f, Lam* f_diff) {
+    auto& world = ckpt->world();
+
+    // ```
+    // checkpoint g: cn[E, cn X]
+    // g': cn[E, cn[X, cn[X, cn E]]]
+    // checkpoint' = λ (args, ret).
+    //   g' (args, λ (res, _). ret (res, λ (s, pb_ret). g' (args, λ (_, g*). g* (s, pb_ret))))
+    // ```
+    // The pullback of the forward call is dropped immediately.
+    // Only the arguments are captured; the pullback is rebuilt by recomputing `g'` during the backward sweep.
+    auto fun     = ckpt->arg();
+    auto aug_fun = augment(fun, f, f_diff);
+    auto aug_ty  = autodiff_type_fun(fun->type())->as<Pi>();
+    auto ret_pi  = aug_ty->dom(2, 1)->as<Pi>();
+    auto pb_ty   = ret_pi->dom(2, 1)->as<Pi>();
+    world.DLOG("checkpoint of {} : {} with augmented type {}", fun, fun->type(), aug_ty);
+
+    // The wrapper must not be partially evaluated at its call site:
+    // Otherwise, the forward call to `g'` ends up in an already visited mutable and is never derived.
+    auto wrap = world.mut_lam(aug_ty)->set("checkpoint");
+    auto args = wrap->var(0_s);
+    auto ret  = wrap->var(1);
+
+    auto re_pb   = world.mut_lam(pb_ty)->set("checkpoint_pb");
+    auto re_cont = world.mut_lam(ret_pi)->set("checkpoint_recompute");
+    re_cont->app(true, re_cont->var(1), {re_pb->var(0_s), re_pb->var(1)});
+    re_pb->app(true, aug_fun, {args, re_cont});
+
+    auto fw_cont = world.mut_lam(ret_pi)->set("checkpoint_forward");
+    fw_cont->app(true, ret, {fw_cont->var(0_s), re_pb});
+    wrap->app(false, aug_fun, {args, fw_cont});
+
+    return wrap;
+}
+
 /// Rewrites the given definition in a lambda environment.
 Ref AutoDiffEval::augment_(Ref def, Lam* f, Lam* f_diff) {
     auto& world = def->world();
@@ -328,6 +372,10 @@ Ref AutoDiffEval::augment_(Ref def, Lam* f, Lam* f_diff) {
 
     // Applications are continuations, operators, or full functions
     if (auto app = def->isa<App>()) {
+        if (auto ckpt = match<checkpoint>(def)) {
+            world.DLOG("Augment checkpoint: {}", ckpt->arg());
+            return augment_checkpoint(ckpt, f, f_diff);
+        }
         auto callee = app->callee();
         auto arg    = app->arg();
         world.DLOG("Augment application: app {} with {}", callee, arg);
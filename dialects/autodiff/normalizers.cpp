@@ -46,11 +46,11 @@ Ref normalize_add(Ref type, Ref callee, Ref arg) {
 
     world.DLOG("add {} {} {}", T, a, b);
 
-    if (match<zero>(a)) {
+    if (is_zero(a)) {
         world.DLOG("0+b");
         return b;
     }
-    if (match<zero>(b)) {
+    if (is_zero(b)) {
         world.DLOG("0+a");
         return a;
     }
@@ -95,11 +95,16 @@ Ref normalize_sum(Ref type, Ref callee, Ref arg) {
     if (auto lit = count->isa<Lit>()) {
         auto val = lit->get<nat_t>();
         world.DLOG("val: {}", val);
-        DefArray args = arg->projs(val);
-        auto sum      = world.app(world.annex<zero>(), T);
+        // Provably zero summands are dropped before any addition is materialized.
+        std::vector<const Def*> args;
+        for (auto op : arg->projs(val))
+            if (!is_zero(op)) args.emplace_back(op);
+        world.DLOG("non-zero summands: {}", args.size());
+
+        auto sum = world.app(world.annex<zero>(), T);
         // This special case would also be handled by add zero
-        if (val >= 1) sum = args[0];
-        for (size_t i = 1; i < val; ++i) sum = world.app(world.app(world.annex<add>(), T), {sum, args[i]});
+        if (!args.empty()) sum = args[0];
+        for (size_t i = 1; i < args.size(); ++i) sum = world.app(world.app(world.annex<add>(), T), {sum, args[i]});
         return sum;
     }
     assert(0);
@@ -107,6 +112,14 @@ Ref normalize_sum(Ref type, Ref callee, Ref arg) {
     return world.raw_app(type, callee, arg);
 }
 
+/// Only function calls can be checkpointed.
+/// On all other terms, the checkpoint is the identity.
+Ref normalize_checkpoint(Ref type, Ref callee, Ref arg) {
+    auto& world = type->world();
+    if (!arg->type()->isa<Pi>()) return arg;
+    return world.raw_app(type, callee, arg);
+}
+
 THORIN_autodiff_NORMALIZER_IMPL
 
 } // namespace thorin::autodiff
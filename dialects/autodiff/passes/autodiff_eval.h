@@ -37,6 +37,7 @@ public:
     Ref augment_lit(const Lit*, Lam*, Lam*);
     Ref augment_tuple(const Tuple*, Lam*, Lam*);
     Ref augment_pack(const Pack* pack, Lam* f, Lam* f_diff);
+    Ref augment_checkpoint(const App*, Lam*, Lam*);
 
 private:
     /// Transforms closed terms (lambda, operator) to derived expressions.
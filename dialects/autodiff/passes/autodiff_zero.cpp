@@ -22,6 +22,9 @@ Ref AutoDiffZero::rewrite(Ref def) {
         return def;
     }
 
+    // Checkpoints that survived the autodiff evaluation are not differentiated and act as identity.
+    if (auto ckpt = match<checkpoint>(def); ckpt) return ckpt->arg();
+
     return def;
 }
 
@@ -337,6 +337,10 @@ D load =
 .rule:
     (%autodiff.autodiff (%core.wrap.mul)) ->
     internal_diff_core_wrap_mul;
+/// shl
+.rule:
+    (%autodiff.autodiff (%core.wrap.shl)) ->
+    internal_diff_core_wrap_shl;
 // cmp
 .rule:
     (%autodiff.autodiff (%core.icmp.xYgLE)) ->
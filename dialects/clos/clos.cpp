@@ -10,6 +10,7 @@
 #include "dialects/clos/pass/fp/lower_typed_clos_prep.h"
 #include "dialects/clos/pass/rw/branch_clos_elim.h"
 #include "dialects/clos/pass/rw/clos2sjlj.h"
+#include "dialects/clos/pass/rw/clos_cfa.h"
 #include "dialects/clos/pass/rw/clos_conv_prep.h"
 #include "dialects/clos/pass/rw/phase_wrapper.h"
 #include "dialects/mem/mem.h"
@@ -24,7 +25,14 @@ extern "C" THORIN_EXPORT Plugin thorin_get_plugin() {
     return {"clos", [](Normalizers& normalizers) { clos::register_normalizers(normalizers); },
             [](Passes& passes) {
                 register_pass<clos::clos_conv_prep_pass, clos::ClosConvPrep>(passes, nullptr);
-                register_pass<clos::clos_conv_pass, clos::ClosConvWrapper>(passes);
+                passes[flags_t(Annex::Base<clos::clos_conv_pass>)] = [&](World&, PipelineBuilder& builder, Ref app) {
+                    auto mode_ax = app->as<App>()->arg()->as<Axiom>();
+                    auto mode    = mode_ax->flags() == flags_t(Annex::Base<clos::env_linked>) ? clos::ClosConv::Linked
+                                 : mode_ax->flags() == flags_t(Annex::Base<clos::env_hybrid>) ? clos::ClosConv::Hybrid
+                                                                                              : clos::ClosConv::Flat;
+                    builder.add_pass<clos::ClosConvWrapper>(app, mode);
+                };
+                register_pass<clos::clos_cfa_pass, clos::ClosCFA>(passes);
                 register_pass<clos::branch_clos_pass, clos::BranchClosElim>(passes);
                 register_pass<clos::lower_typed_clos_prep_pass, clos::LowerTypedClosPrep>(passes);
                 register_pass<clos::clos2sjlj_pass, clos::Clos2SJLJ>(passes);
@@ -1,5 +1,9 @@
 #include "dialects/clos/pass/rw/clos2sjlj.h"
 
+#include <functional>
+
+#include "thorin/analyses/scope.h"
+
 #include "dialects/clos/autogen.h"
 #include "dialects/core/core.h"
 
@@ -41,6 +45,13 @@ Ref rebuild(Ref mem, Ref env, Defs remaining) {
     return w.tuple(new_ops);
 }
 
+/// Does @p def contain a closure of one of the @p lams?
+bool has_clos(Ref def, const LamMap<std::pair<int, Ref>>& lams, DefSet& visited) {
+    if (!def->is_term() || def->isa_mut<Lam>() || !visited.emplace(def).second) return false;
+    if (auto c = isa_clos_lit(def); c && lams.contains(c.fnc_as_lam())) return true;
+    return std::ranges::any_of(def->ops(), [&](auto op) { return has_clos(op, lams, visited); });
+}
+
 } // namespace
 
 void Clos2SJLJ::get_exn_closures(Ref def, DefSet& visited) {
@@ -120,10 +131,154 @@ Lam* Clos2SJLJ::get_lpad(Lam* lam, Ref rb) {
     return lpad;
 }
 
+/// The call `f (..., exn, ..., k)` in the body of curr_mut() is rewritten to `f' (..., k')`, where `f'`
+/// returns a tag along with the results of either `k` or `exn` to `k'` which in turn dispatches on this tag.
+/// This is only sound if `f` invokes `exn` merely in its own frame, i.e. in `f` itself or one of its basic blocks.
+/// Unlike `setjmp`, this does not cost anything on entry - only a branch on return.
+bool Clos2SJLJ::ret_code() {
+    auto& w  = world();
+    auto app = curr_mut()->body()->as<App>();
+    auto f   = app->callee()->isa_mut<Lam>();
+    if (!f || !isa_workable(f) || !f->ret_var() || f->num_vars() != app->num_args()) return false;
+
+    auto exns    = std::vector<std::pair<size_t, Ref>>();
+    auto visited = DefSet();
+    for (size_t i = 0, e = app->num_args(); i != e; ++i) {
+        auto arg = app->arg(i);
+        if (auto c = isa_clos_lit(arg); c && lam2tag_.contains(c.fnc_as_lam())) {
+            exns.emplace_back(i, arg);
+            arg = c.env();
+        }
+        if (has_clos(arg, lam2tag_, visited)) return false;
+    }
+    if (exns.empty()) return false;
+
+    // Closures must only be used as branches; otherwise, they may escape the frame of f.
+    auto scope  = Scope(f);
+    auto branch = [&](Ref def) {
+        for (auto use : def->uses()) {
+            if (!scope.bound(use)) continue;
+            if (auto tuple = use->isa<Tuple>()) {
+                for (auto tuple_use : tuple->uses())
+                    if (scope.bound(tuple_use) && !tuple_use->isa<Extract>()) return false;
+            } else if (!use->isa<Extract>()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (auto def : scope.bound()) {
+        if (auto lam = def->isa_mut<Lam>(); lam && lam != f && !Lam::isa_basicblock(lam)) return false;
+        if (isa_clos_lit(def) && !branch(def)) return false;
+    }
+    for (auto use : f->var()->uses())
+        if (scope.bound(use) && (!use->isa<Extract>() || !Lit::isa(use->as<Extract>()->index()))) return false;
+    // The exception closure may only be invoked or captured by branches of f.
+    std::function<bool(Ref)> local = [&](Ref def) {
+        for (auto use : def->uses()) {
+            if (!scope.bound(use)) continue;
+            if (auto extract = use->isa<Extract>(); extract && Lit::isa(extract->index())) {
+                if (Lit::as(extract->index()) == 1)
+                    for (auto callee_use : extract->uses())
+                        if (scope.bound(callee_use) && (!callee_use->isa<App>() || callee_use.index() != 0))
+                            return false;
+            } else if (auto c = isa_clos_lit(use.def()); c && use.index() == 2) {
+                if (!local(c.fnc_as_lam()->var(Clos_Env_Param))) return false;
+            } else if (auto env = use->isa<Tuple>()) {
+                for (auto env_use : env->uses()) {
+                    if (!scope.bound(env_use)) continue;
+                    auto c = isa_clos_lit(env_use.def());
+                    if (!c || env_use.index() != 2) return false;
+                    auto env_var = c.fnc_as_lam()->var(Clos_Env_Param);
+                    if (!local(env_var->proj(env->num_ops(), use.index()))) return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (auto [i, _] : exns)
+        if (!local(f->var(i))) return false;
+
+    // k' expects [%mem.M, tag, results of k..., arguments of exn_1..., ..., arguments of exn_n...].
+    auto pis   = std::vector<const Pi*>{f->ret_pi()};
+    auto skips = std::vector<size_t>{1};
+    for (auto [i, _] : exns) {
+        pis.emplace_back(clos_type_to_pi(f->var(i)->type(), w.sigma()));
+        skips.emplace_back(2);
+    }
+    auto k_doms = DefVec{w.annex<mem::M>(), w.type_idx(pis.size())};
+    for (size_t j = 0; j != pis.size(); ++j)
+        for (size_t i = skips[j], e = pis[j]->num_doms(); i != e; ++i) k_doms.emplace_back(pis[j]->dom(i));
+    auto k_pi = w.cn(k_doms);
+
+    auto keep = std::vector<size_t>();
+    for (size_t i = 0, e = f->num_vars() - 1; i != e; ++i)
+        if (std::ranges::none_of(exns, [i](auto exn) { return exn.first == i; })) keep.emplace_back(i);
+
+    auto key      = w.tuple({f, w.tuple(DefArray(exns.size(), [&](auto j) { return w.lit_nat(exns[j].first); }))});
+    auto [p, ins] = lam2ret_code_.emplace(key, nullptr);
+    auto& new_f   = p->second;
+    if (ins) {
+        // f' drops the exception closures and returns to k'.
+        auto doms = DefVec();
+        for (auto i : keep) doms.emplace_back(f->dom(i));
+        doms.emplace_back(k_pi);
+        new_f  = f->stub(w, w.cn(doms));
+        auto k = new_f->ret_var();
+        // Passes the j-th segment - the vars of lam - together with tag j to k' and ⊥ for all other segments.
+        auto jump = [&](Lam* lam, size_t j) {
+            auto args = DefVec{mem::mem_var(lam), w.lit_idx(pis.size(), j)};
+            for (size_t s = 0; s != pis.size(); ++s)
+                for (size_t i = skips[s], e = pis[s]->num_doms(); i != e; ++i)
+                    args.emplace_back(s == j ? lam->var(i) : w.bot(pis[s]->dom(i)));
+            lam->app(false, k, args);
+            return lam;
+        };
+
+        auto args = DefArray(f->num_vars());
+        for (size_t i = 0; i != keep.size(); ++i) args[keep[i]] = new_f->var(i);
+        args.back() = jump(w.mut_lam(f->ret_pi())->set("ret_code"), 0);
+        for (size_t j = 1; j != pis.size(); ++j) {
+            auto i          = exns[j - 1].first;
+            auto throw_code = jump(w.mut_lam(pis[j])->set("throw_code"), j);
+            args[i]         = clos_pack(w.tuple(), throw_code, f->var(i)->type());
+            ignore_.emplace(throw_code);
+        }
+        new_f->set(f->reduce(w.tuple(args)));
+        w.DLOG("lower exceptions of {} to return codes: {}", f, new_f);
+    }
+
+    auto dispatch = w.mut_lam(k_pi)->set("dispatch");
+    auto bbs      = DefVec(pis.size());
+    for (size_t j = 0, o = 2; j != pis.size(); o += pis[j]->num_doms() - skips[j], ++j) {
+        auto bb   = w.mut_lam(w.cn(w.annex<mem::M>()))->set(j == 0 ? "ret" : "lpad");
+        auto args = DefVec{bb->var()};
+        for (size_t i = 0, e = pis[j]->num_doms() - skips[j]; i != e; ++i) args.emplace_back(dispatch->var(o + i));
+        if (j == 0)
+            bb->app(false, app->args().back(), args);
+        else
+            bb->set(false, clos_apply(exns[j - 1].second, w.tuple(args)));
+        bbs[j] = bb;
+    }
+    dispatch->app(false, w.extract(w.tuple(bbs), dispatch->var(1)), mem::mem_var(dispatch));
+
+    auto new_args = DefVec();
+    for (auto i : keep) new_args.emplace_back(app->arg(i));
+    new_args.emplace_back(dispatch);
+    curr_mut()->reset({curr_mut()->filter(), w.app(new_f, new_args)});
+    return true;
+}
+
 void Clos2SJLJ::enter() {
     auto& w = world();
     get_exn_closures();
     if (lam2tag_.empty()) return;
+    if (ret_code()) {
+        lam2tag_.clear();
+        return;
+    }
 
     {
         auto m0       = mem::mem_var(curr_mut());
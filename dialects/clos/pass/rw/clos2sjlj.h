@@ -7,6 +7,9 @@
 
 namespace thorin::clos {
 
+/// Lowers first-class continuations (*exception closures*) that escape into a call to `setjmp`/`longjmp`.
+/// If all of them are passed to a known function that only ever invokes them in its own frame, the call is instead
+/// lowered to *return codes* (see Clos2SJLJ::ret_code).
 class Clos2SJLJ : public RWPass<Clos2SJLJ, Lam> {
 public:
     Clos2SJLJ(PassMan& man)
@@ -14,6 +17,7 @@ public:
         , lam2tag_()
         , dom2throw_()
         , lam2lpad_()
+        , lam2ret_code_()
         , ignore_() {}
 
     void enter() override;
@@ -27,6 +31,7 @@ private:
 
     Lam* get_throw(Ref res_type);
     Lam* get_lpad(Lam* lam, Ref rb);
+    bool ret_code();
 
     void get_exn_closures();
     void get_exn_closures(Ref def, DefSet& visited);
@@ -35,6 +40,7 @@ private:
     LamMap<std::pair<int, Ref>> lam2tag_;
     DefMap<Lam*> dom2throw_;
     DefMap<Lam*> lam2lpad_;
+    DefMap<Lam*> lam2ret_code_;
     LamSet ignore_;
     // clang-format on
 
@@ -0,0 +1,177 @@
+#include "dialects/clos/pass/rw/clos_cfa.h"
+
+#include <algorithm>
+
+#include "dialects/clos/clos.h"
+
+namespace thorin::clos {
+
+namespace {
+
+bool is_clos(Ref def) { return def->type() && isa_clos_type(def->type()); }
+
+/// Yields the closure-typed parameter of @p def if @p def is one.
+std::tuple<Lam*, size_t> isa_clos_var(Ref def) {
+    if (!is_clos(def)) return {nullptr, 0};
+    if (auto var = def->isa<Var>()) {
+        if (auto lam = var->mut()->isa_mut<Lam>()) return {lam, 0};
+    }
+    if (auto [proj, lam] = ca_isa_var<Lam>(def); proj && lam) {
+        if (auto i = Lit::isa(proj->index())) return {lam, *i};
+    }
+    return {nullptr, 0};
+}
+
+} // namespace
+
+void ClosCFA::prepare() {
+    DefVec defs;
+    unique_stack<DefSet> stack;
+    for (const auto& [_, mut] : world().externals()) stack.push(mut);
+
+    while (!stack.empty()) {
+        auto def = stack.pop();
+        defs.emplace_back(def);
+        for (auto op : def->ops())
+            if (op) stack.push(op);
+    }
+
+    for (auto def : defs)
+        if (auto lam = def->isa_mut<Lam>(); lam && !isa_workable(lam)) escape(lam);
+
+    for (bool todo = true; todo;) {
+        todo = false;
+        for (auto def : defs) {
+            if (auto app = def->isa<App>()) {
+                if (auto lams = callees(app->callee())) {
+                    for (auto lam : *lams) {
+                        for (size_t i = 0, n = app->num_args(); i != n; ++i)
+                            if (is_clos(app->arg(n, i))) todo |= join(lam->var(n, i), clos(app->arg(n, i)));
+                    }
+                } else {
+                    for (size_t i = 0, n = app->num_args(); i != n; ++i)
+                        if (is_clos(app->arg(n, i))) todo |= escape(clos(app->arg(n, i)));
+                }
+            }
+
+            for (size_t i = 0, e = def->num_ops(); i != e; ++i) {
+                auto op = def->op(i);
+                if (!op || is_known_use(def, i)) continue;
+                if (is_clos(op)) todo |= escape(clos(op));
+                if (auto lam = op->isa_mut<Lam>()) todo |= escape(lam);
+            }
+        }
+    }
+
+    for (const auto& [var, clos] : var2clos_)
+        if (!unknown_.contains(var) && clos.size() > 1)
+            world().DLOG("{} closures may flow into '{}': {, }", clos.size(), var, clos);
+}
+
+Ref ClosCFA::rewrite(Ref def) {
+    auto app = def->isa<App>();
+    auto fn  = app ? app->callee()->isa<Extract>() : nullptr;
+    if (!fn || !is_clos(fn->tuple()) || Lit::isa(fn->index()) != 1) return def;
+
+    if (auto clos = this->clos(fn->tuple()); clos && clos->size() == 1) {
+        auto c = isa_clos_lit(*clos->begin());
+        if (c.env()->has_dep(Dep::Var)) return def;
+
+        world().DLOG("known closure '{}' at call site '{}'", c.fnc(), def);
+        return world().app(c.fnc(), clos_sub_env(app->arg(), c.env()));
+    }
+
+    return def;
+}
+
+ClosCFA::Clos ClosCFA::clos(Ref def) {
+    if (isa_clos_lit(def)) return DefSet{def};
+
+    if (auto [lam, _] = isa_clos_var(def); lam) {
+        if (unknown_.contains(def)) return {};
+        return var2clos_[def];
+    }
+
+    if (auto extract = def->isa<Extract>()) {
+        if (auto tuple = extract->tuple()->isa<Tuple>()) {
+            if (auto i = Lit::isa(extract->index())) return clos(tuple->op(*i));
+
+            DefSet res; // any of them
+            for (auto op : tuple->ops()) {
+                auto clos = this->clos(op);
+                if (!clos) return {};
+                res.insert(clos->begin(), clos->end());
+            }
+            return res;
+        }
+    }
+
+    return {};
+}
+
+std::optional<std::vector<Lam*>> ClosCFA::callees(Ref callee) {
+    if (auto lam = callee->isa_mut<Lam>()) {
+        if (isa_workable(lam)) return std::vector<Lam*>{lam};
+        return {};
+    }
+
+    if (auto fn = callee->isa<Extract>(); fn && is_clos(fn->tuple()) && Lit::isa(fn->index()) == 1) {
+        auto clos = this->clos(fn->tuple());
+        if (!clos) return {};
+
+        std::vector<Lam*> lams;
+        for (auto def : *clos) {
+            auto lam = isa_workable(isa_clos_lit(def).fnc_as_lam());
+            if (!lam) return {};
+            lams.emplace_back(lam);
+        }
+        return lams;
+    }
+
+    return {};
+}
+
+bool ClosCFA::join(Ref var, const Clos& clos) {
+    if (unknown_.contains(var)) return false;
+    if (!clos) return unknown_.emplace(var).second;
+
+    bool todo  = false;
+    auto& vals = var2clos_[var];
+    for (auto def : *clos) todo |= vals.emplace(def).second;
+    return todo;
+}
+
+bool ClosCFA::escape(const Clos& clos) {
+    bool todo = false;
+    if (clos)
+        for (auto def : *clos)
+            if (auto lam = isa_clos_lit(def).fnc_as_lam()) todo |= escape(lam);
+    return todo;
+}
+
+/// @p lam may be called from anywhere: All its closure-typed parameters receive unknown closures.
+bool ClosCFA::escape(Lam* lam) {
+    bool todo = false;
+    for (size_t i = 0, n = lam->num_vars(); i != n; ++i) {
+        auto var = lam->var(n, i);
+        if (is_clos(var)) todo |= unknown_.emplace(var).second;
+    }
+    return todo;
+}
+
+/// Is the @p i%th op of @p def a use we keep track of?
+/// These are the callee and the arguments of an App, projections, and the function of a closure literal.
+/// A Tuple only qualifies if all its uses are known as well.
+bool ClosCFA::is_known_use(Ref def, size_t i) {
+    if (def->isa<Var>() || def->isa<Extract>()) return true;
+    if (auto app = def->isa<App>()) return i == 0 || !app->arg()->isa_mut<Lam>() || match<attr>(def);
+    if (isa_clos_lit(def)) return i != 2;
+    if (def->isa<Tuple>()) {
+        return std::ranges::all_of(def->uses(), [](Use use) {
+            return (use->isa<App>() && use.index() == 1) || (use->isa<Extract>() && use.index() == 0);
+        });
+    }
+    return false;
+}
+
+} // namespace thorin::clos
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+
+#include "thorin/pass/pass.h"
+
+namespace thorin::clos {
+
+/// Whole-program 0-CFA over the typed closure representation produced by ClosConv.
+/// For each closure-typed parameter, it computes the set of closure literals that may flow into it.
+/// A closure literal *escapes* - and the parameters of its function receive unknown closures - as soon as it is used in
+/// any other way than being passed to a known function or being called; e.g. by being stored to memory, returned, or
+/// put into the environment of another closure.
+///
+/// A call through a parameter, whose set consists of a single closure with a closed environment, becomes a direct call
+/// which passes this environment as is.
+/// @note Larger sets are only reported: The typed closure representation provides neither a way to tell closures
+/// apart at runtime nor to unpack an environment of unknown type.
+class ClosCFA : public RWPass<ClosCFA, Lam> {
+public:
+    ClosCFA(PassMan& man)
+        : RWPass(man, "clos_cfa") {}
+
+    void prepare() override;
+    Ref rewrite(Ref) override;
+
+private:
+    /// Closure literals that may flow into a Def or `std::nullopt` if unknown.
+    using Clos = std::optional<DefSet>;
+
+    Clos clos(Ref);
+    std::optional<std::vector<Lam*>> callees(Ref callee);
+    bool join(Ref var, const Clos&);
+    bool escape(const Clos&);
+    bool escape(Lam*);
+    bool is_known_use(Ref def, size_t i);
+
+    DefMap<DefSet> var2clos_;
+    DefSet unknown_; ///< Closure-typed Var%s that may receive unknown closures.
+};
+
+} // namespace thorin::clos
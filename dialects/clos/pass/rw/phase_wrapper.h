@@ -10,10 +10,14 @@ namespace thorin::clos {
 
 class ClosConvWrapper : public RWPass<ClosConvWrapper, Lam> {
 public:
-    ClosConvWrapper(PassMan& man)
-        : RWPass(man, "clos_conv") {}
+    ClosConvWrapper(PassMan& man, ClosConv::Mode mode)
+        : RWPass(man, "clos_conv")
+        , mode_(mode) {}
 
-    void prepare() override { clos::ClosConv(world()).run(); }
+    void prepare() override { clos::ClosConv(world(), mode_).run(); }
+
+private:
+    ClosConv::Mode mode_;
 };
 
 class LowerTypedClosWrapper : public RWPass<LowerTypedClosWrapper, Lam> {
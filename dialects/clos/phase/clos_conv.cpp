@@ -125,30 +125,41 @@ void ClosConv::rewrite_body(Lam* new_lam, Def2Def& subst) {
     auto& w = world();
     auto it = closures_.find(new_lam);
     assert(it != closures_.end() && "closure should have a stub if rewrite_body is called!");
-    auto [old_fn, num_fvs, env, new_fn] = it->second;
+    auto stub                              = it->second;
+    auto [old_fn, num_fvs, env, new_fn, _] = stub;
 
     if (!old_fn->is_set()) return;
 
     w.DLOG("rw body: {} [old={}, env={}]\nt", new_fn, old_fn, env);
     auto env_param = new_fn->var(Clos_Env_Param)->set("closure_env");
-    if (num_fvs == 1) {
-        subst.emplace(env, env_param);
-    } else {
-        for (size_t i = 0; i < num_fvs; i++) {
-            auto fv  = env->op(i);
-            auto sym = w.sym("fv_"s + (fv->sym() ? *fv->sym() : std::to_string(i)));
-            subst.emplace(fv, env_param->proj(i)->set(sym));
-        }
-    }
+    subst_env(stub, env_param, subst);
 
     auto params = w.tuple(DefArray(old_fn->num_doms(), [&](auto i) { return new_lam->var(skip_env(i)); }));
     subst.emplace(old_fn->var(), params);
 
+    // Basic blocks without environment share subst with their parent and are therefore transparent.
+    auto curr   = num_fvs == 0 ? curr_ : std::exchange(curr_, old_fn);
     auto filter = rewrite(new_fn->filter(), subst);
     auto body   = rewrite(new_fn->body(), subst);
+    curr_       = curr;
     new_fn->reset({filter, body});
 }
 
+void ClosConv::subst_env(const Stub& stub, const Def* env_param, Def2Def& subst) {
+    for (size_t i = 0; i < stub.num_fvs; i++) {
+        auto fv  = stub.num_fvs == 1 ? stub.env : stub.env->op(i);
+        auto var = env_param->proj(stub.num_fvs, i);
+        if (i == 0 && stub.link) {
+            subst_env(closures_.find(stub.link)->second, var, subst);
+        } else if (stub.num_fvs == 1) {
+            subst.emplace(fv, var);
+        } else {
+            auto sym = world().sym("fv_"s + (fv->sym() ? *fv->sym() : std::to_string(i)));
+            subst.emplace(fv, var->set(sym));
+        }
+    }
+}
+
 const Def* ClosConv::rewrite(const Def* def, Def2Def& subst) {
     switch (def->node()) {
         case Node::Type:
@@ -171,10 +182,10 @@ const Def* ClosConv::rewrite(const Def* def, Def2Def& subst) {
     } else if (auto pi = Pi::isa_cn(def)) {
         return map(type_clos(pi, subst));
     } else if (auto lam = def->isa_mut<Lam>(); lam && Lam::isa_cn(lam)) {
-        auto [_, __, fv_env, new_lam] = make_stub(lam, subst);
-        auto clos_ty                  = rewrite(lam->type(), subst);
-        auto env                      = rewrite(fv_env, subst);
-        auto closure                  = clos_pack(env, new_lam, clos_ty);
+        auto [_, __, fv_env, new_lam, ___] = make_stub(lam, subst);
+        auto clos_ty                       = rewrite(lam->type(), subst);
+        auto env                           = rewrite(fv_env, subst);
+        auto closure                       = clos_pack(env, new_lam, clos_ty);
         world().DLOG("RW: pack {} ~> {} : {}", lam, closure, clos_ty);
         return map(closure);
     } else if (auto a = match<attr>(def)) {
@@ -200,8 +211,8 @@ const Def* ClosConv::rewrite(const Def* def, Def2Def& subst) {
                 // Note: Same thing about η-conversion applies here
                 auto bb_lam = a->arg()->isa_mut<Lam>();
                 assert(bb_lam && Lam::isa_basicblock(bb_lam));
-                auto [_, __, ___, new_lam] = make_stub({}, bb_lam, subst);
-                subst[bb_lam]              = clos_pack(w.tuple(), new_lam, rewrite(bb_lam->type(), subst));
+                auto new_lam  = make_stub({}, bb_lam, subst).fn;
+                subst[bb_lam] = clos_pack(w.tuple(), new_lam, rewrite(bb_lam->type(), subst));
                 rewrite_body(new_lam, subst);
                 return map(subst[bb_lam]);
             }
@@ -276,9 +287,20 @@ const Def* ClosConv::type_clos(const Pi* pi, Def2Def& subst, const Def* env_type
 }
 
 ClosConv::Stub ClosConv::make_stub(const DefSet& fvs, Lam* old_lam, Def2Def& subst) {
-    auto& w          = world();
-    auto env         = w.tuple(DefArray(fvs.begin(), fvs.end()));
-    auto num_fvs     = fvs.size();
+    auto& w     = world();
+    auto parent = link(fvs, old_lam);
+    auto elems  = DefVec();
+    if (parent) {
+        auto& pfvs = fva_.run(parent);
+        elems.emplace_back(closures_.find(parent)->second.env);
+        for (auto fv : fvs)
+            if (!pfvs.contains(fv)) elems.emplace_back(fv);
+        w.DLOG("link env of {} to {}", old_lam, parent);
+    } else {
+        elems.assign(fvs.begin(), fvs.end());
+    }
+    auto env         = w.tuple(elems);
+    auto num_fvs     = elems.size();
     auto env_type    = rewrite(env->type(), subst);
     auto new_fn_type = type_clos(old_lam->type(), subst, env_type)->as<Pi>();
     auto new_lam     = old_lam->stub(w, new_fn_type);
@@ -301,12 +323,32 @@ ClosConv::Stub ClosConv::make_stub(const DefSet& fvs, Lam* old_lam, Def2Def& sub
         new_lam->set(old_lam->filter(), old_lam->body());
     }
     w.DLOG("STUB {} ~~> ({}, {})", old_lam, env, new_lam);
-    auto closure = Stub{old_lam, num_fvs, env, new_lam};
+    auto closure = Stub{old_lam, num_fvs, env, new_lam, parent};
     closures_.emplace(old_lam, closure);
     closures_.emplace(closure.fn, closure);
     return closure;
 }
 
+/// The environment of the current parent can be linked if all of its free Def%s are free in @p lam as well.
+/// Then, the new environment is never larger than the flat one, and each construction inside the parent saves
+/// `|parent fvs| - 1` elements.
+/// In turn, each access of a linked free Def in @p lam needs an additional projection.
+/// In Mode::Hybrid, we only link if the savings for all constructions outweigh the accesses.
+Lam* ClosConv::link(const DefSet& fvs, Lam* lam) {
+    if (mode_ == Flat || !curr_ || curr_ == lam || !isa_workable(lam) || !closures_.contains(curr_)) return nullptr;
+
+    auto& pfvs = fva_.run(curr_);
+    if (pfvs.size() < 2 || !std::ranges::all_of(pfvs, [&](auto fv) { return fvs.contains(fv); })) return nullptr;
+    if (mode_ == Linked) return curr_;
+
+    auto scope    = Scope(lam);
+    size_t access = 0;
+    for (auto fv : pfvs)
+        for (auto use : fv->uses()) access += scope.bound(use);
+    size_t savings = (pfvs.size() - 1) * lam->num_uses();
+    return savings >= access ? curr_ : nullptr;
+}
+
 ClosConv::Stub ClosConv::make_stub(Lam* old_lam, Def2Def& subst) {
     if (auto i = closures_.find(old_lam); i != closures_.end()) return i->second;
     auto fvs     = fva_.run(old_lam);
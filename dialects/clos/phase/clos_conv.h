@@ -88,11 +88,24 @@ private:
 /// `ax : (B : *, int -> B) -> (int -> B)` won't be converted, possible arguments may.
 /// Further, there is no machinery to handle free variables in a Lam%s type; this may lead to
 /// problems with polymorphic functions.
+///
+/// The environment of a closure is built according to ClosConv::Mode.
+/// A *linked* environment `(parent_env, fvs...)` reuses the environment of the closure in whose body it is created,
+/// provided that all free Def%s of the parent are also free in the new closure.
+/// Inside the parent, `parent_env` is just its own environment parameter, so it is not copied element-wise.
 class ClosConv : public Phase {
 public:
-    ClosConv(World& world)
+    /// How environments are laid out.
+    enum Mode {
+        Flat,   ///< One element per free Def (default).
+        Linked, ///< Link to the parent's environment whenever possible.
+        Hybrid, ///< Link only if the construction savings outweigh the additional projections (see ClosConv::link).
+    };
+
+    ClosConv(World& world, Mode mode = Flat)
         : Phase(world, "clos_conv", true)
-        , fva_(world) {}
+        , fva_(world)
+        , mode_(mode) {}
 
     void start() override;
 
@@ -101,13 +114,18 @@ private:
     /// @{
     struct Stub {
         Lam* old_fn;
-        size_t num_fvs;
+        size_t num_fvs; ///< Number of elements in the environment.
         const Def* env;
         Lam* fn;
+        Lam* link; ///< Parent whose environment is the first element of ClosConv::Stub::env or @c nullptr.
     };
 
     Stub make_stub(const DefSet& fvs, Lam* lam, Def2Def& subst);
     Stub make_stub(Lam* lam, Def2Def& subst);
+    /// Returns the parent to link the environment of @p lam with free Def%s @p fvs to or @c nullptr.
+    Lam* link(const DefSet& fvs, Lam* lam);
+    /// Substitutes the free Def%s of @p stub with the corresponding projections of @p env_param.
+    void subst_env(const Stub& stub, const Def* env_param, Def2Def& subst);
     /// @}
 
     /// @name Recursively rewrite Def%s.
@@ -120,7 +138,9 @@ private:
     /// @}
 
     FreeDefAna fva_;
+    Mode mode_;
     DefMap<Stub> closures_;
+    Lam* curr_ = nullptr; ///< Old Lam whose body is currently rewritten.
 
     // Muts that must be re rewritten uniformly across the whole module:
     // Currently, this includes globals and closure types (for typechecking to go through).
@@ -8,6 +8,7 @@
 #include "thorin/pass/fp/eta_red.h"
 #include "thorin/pass/fp/tail_rec_elim.h"
 #include "thorin/pass/pipelinebuilder.h"
+#include "thorin/pass/rw/inliner.h"
 #include "thorin/pass/rw/lam_spec.h"
 #include "thorin/pass/rw/ret_wrap.h"
 #include "thorin/pass/rw/scalarize.h"
@@ -70,6 +71,7 @@ extern "C" THORIN_EXPORT thorin::Plugin thorin_get_plugin() {
                     [](World&, PipelineBuilder& builder, const Def* def) { builder.def2pass(def, nullptr); });
 
                 register_pass<compile::beta_red_pass, BetaRed>(passes);
+                register_pass<compile::inliner_pass, Inliner>(passes);
                 register_pass<compile::eta_red_pass, EtaRed>(passes);
 
                 register_pass<compile::lam_spec_pass, LamSpec>(passes);
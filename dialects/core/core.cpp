@@ -2,13 +2,20 @@
 
 #include <thorin/config.h>
 #include <thorin/pass/pass.h>
+#include <thorin/pass/pipelinebuilder.h>
 
 #include "dialects/core/be/ll.h"
+#include "dialects/core/phases/dead_arg_elim.h"
+#include "dialects/core/phases/sccp.h"
 
 using namespace thorin;
 
 extern "C" THORIN_EXPORT Plugin thorin_get_plugin() {
-    return {"core", [](Normalizers& normalizers) { core::register_normalizers(normalizers); }, nullptr,
+    return {"core", [](Normalizers& normalizers) { core::register_normalizers(normalizers); },
+            [](Passes& passes) {
+                register_phase<core::sccp_phase, core::SCCP>(passes);
+                register_phase<core::dead_arg_elim_phase, core::DeadArgElim>(passes);
+            },
             [](Backends& backends) { backends["ll"] = &ll::emit; }};
 }
 
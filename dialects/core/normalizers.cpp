@@ -1,5 +1,7 @@
 #include <optional>
 
+#include "thorin/rule.h"
+
 #include "dialects/core/core.h"
 #include "dialects/math/math.h"
 #include "dialects/mem/mem.h"
@@ -48,12 +50,12 @@ Res fold(u64 a, u64 b, [[maybe_unused]] bool nsw, [[maybe_unused]] bool nuw) {
 
     if constexpr (std::is_same_v<Id, wrap>) {
         if constexpr (id == wrap::add) {
-            auto res = u + v;
+            auto res = std::is_same_v<UT, bool> ? UT(u ^ v) : UT(u + v);
             if (nuw && res < u) return {};
             // TODO nsw
             return res;
         } else if constexpr (id == wrap::sub) {
-            auto res = u - v;
+            auto res = std::is_same_v<UT, bool> ? UT(u ^ v) : UT(u - v);
             //  TODO nsw
             return res;
         } else if constexpr (id == wrap::mul) {
@@ -77,16 +79,16 @@ Res fold(u64 a, u64 b, [[maybe_unused]] bool nsw, [[maybe_unused]] bool nuw) {
     } else if constexpr (std::is_same_v<Id, shr>) {
         if (b >= w) return {};
         if constexpr (false) {}
-        else if constexpr (id == shr::a) return s >> t;
-        else if constexpr (id == shr::l) return u >> v;
+        else if constexpr (id == shr::a) return ST(s >> t);
+        else if constexpr (id == shr::l) return UT(u >> v);
         else []<bool flag = false>() { static_assert(flag, "missing sub tag"); }();
     } else if constexpr (std::is_same_v<Id, div>) {
         if (b == 0) return {};
         if constexpr (false) {}
-        else if constexpr (id == div::sdiv) return s / t;
-        else if constexpr (id == div::udiv) return u / v;
-        else if constexpr (id == div::srem) return s % t;
-        else if constexpr (id == div::urem) return u % v;
+        else if constexpr (id == div::sdiv) return ST(s / t);
+        else if constexpr (id == div::udiv) return UT(u / v);
+        else if constexpr (id == div::srem) return ST(s % t);
+        else if constexpr (id == div::urem) return UT(u % v);
         else []<bool flag = false>() { static_assert(flag, "missing sub tag"); }();
     } else if constexpr (std::is_same_v<Id, icmp>) {
         bool res = false;
@@ -120,16 +122,16 @@ Ref fold(World& world, Ref type, const Def*& a, const Def*& b, Ref mode = {}) {
                 nuw    = m & Mode::nuw;
             }
 
+            using F                = Res (*)(u64, u64, bool, bool);
+            static constexpr auto folds = width_table<F>([]<nat_t w>() -> F { return &fold<Id, id, w>; });
+
             Res res;
-            switch (width) {
-#define CODE(i) \
-    case i: res = fold<Id, id, i>(*la, *lb, nsw, nuw); break;
-                THORIN_1_8_16_32_64(CODE)
-#undef CODE
-                default:
-                    // TODO this is super rough but at least better than just bailing out
-                    res = fold<Id, id, 64>(*la, *lb, false, false);
-                    if (res && !std::is_same_v<Id, icmp>) *res %= size;
+            if (auto i = width2index(width)) {
+                res = folds[*i](*la, *lb, nsw, nuw);
+            } else {
+                // TODO this is super rough but at least better than just bailing out
+                res = fold<Id, id, 64>(*la, *lb, false, false);
+                if (res && !std::is_same_v<Id, icmp>) *res %= size;
             }
 
             return res ? world.lit(type, *res) : world.bot(type);
@@ -203,6 +205,63 @@ Ref merge_cmps(std::array<std::array<u64, 2>, 2> tab, Ref a, Ref b) {
     return nullptr;
 }
 
+/*
+ * Rules
+ */
+
+using namespace rule;
+
+/// Sum of the shift amounts @p I and @p J stays below the bit width.
+template<size_t I, size_t J>
+struct ShiftFits {
+    static bool check(const Env& env) {
+        auto w = Idx::size2bitwidth(Idx::size(env.type()));
+        return w && env.lit(I) + env.lit(J) < *w;
+    }
+};
+
+// clang-format off
+template<class A, class B> using Add  = Op<wrap::add,  A, B>;
+template<class A, class B> using Mul  = Op<wrap::mul,  A, B>;
+template<class A, class B> using Shl  = Op<wrap::shl,  A, B>;
+template<class A, class B> using ShrL = Op<shr::l,     A, B>;
+template<class A, class B> using And  = Op<bit2::and_, A, B>;
+
+/// Rules that apply after folding and commuting - i.e. a Lit operand of a commutative operation is on the left.
+template<auto id> struct Simplify : Rules<> {};
+
+template<> struct Simplify<wrap::add> : Rules<
+    // c0 + (c1 + x) -> (c0 + c1) + x
+    Rule<Add<Const<0>, Add<Const<1>, Any<2>>>, Add<Add<Const<0>, Const<1>>, Any<2>>>
+> {};
+template<> struct Simplify<wrap::mul> : Rules<
+    // 2^k * x -> x << k
+    Rule<Mul<Pow2<0>, Any<1>>, Shl<Any<1>, Log2<0>>>,
+    // c0 * (c1 * x) -> (c0 * c1) * x
+    Rule<Mul<Const<0>, Mul<Const<1>, Any<2>>>, Mul<Mul<Const<0>, Const<1>>, Any<2>>>
+> {};
+template<> struct Simplify<wrap::shl> : Rules<
+    // (x << c1) << c2 -> x << (c1 + c2)
+    Rule<Shl<Shl<Any<0>, Const<1>>, Const<2>>, Shl<Any<0>, Sum<1, 2>>, ShiftFits<1, 2>>
+> {};
+template<shr id> struct Simplify<id> : Rules<
+    // (x >> c1) >> c2 -> x >> (c1 + c2)
+    Rule<Op<id, Op<id, Any<0>, Const<1>>, Const<2>>, Op<id, Any<0>, Sum<1, 2>>, ShiftFits<1, 2>>
+> {};
+template<bit2 id> requires(id == bit2::and_ || id == bit2::or_ || id == bit2::xor_) struct Simplify<id> : Rules<
+    // c0 op (c1 op x) -> (c0 op c1) op x
+    Rule<Op<id, Const<0>, Op<id, Const<1>, Any<2>>>, Op<id, Op<id, Const<0>, Const<1>>, Any<2>>>
+> {};
+template<> struct Simplify<div::udiv> : Rules<
+    // x / 2^k -> x >> k
+    Rule<Op<div::udiv, Any<0>, Pow2<1>>, ShrL<Any<0>, Log2<1>>>
+> {};
+template<> struct Simplify<div::urem> : Rules<
+    // x % 2^k -> (2^k - 1) & x
+    Rule<Op<div::urem, Any<0>, Pow2<1>>, And<Dec<1>, Any<0>>>
+> {};
+// clang-format on
+
 } // namespace
 
 template<nat id>
@@ -369,6 +428,7 @@ Ref normalize_bit2(Ref type, Ref c, Ref arg) {
         }
     }
 
+    if (auto res = Simplify<id>::apply(Env(type, Lit::isa(callee->arg()).value_or(0)), a, b)) return res;
     if (auto res = reassociate<bit2>(id, world, callee, a, b)) return res;
 
     return world.raw_app(type, callee, {a, b});
@@ -415,6 +475,8 @@ Ref normalize_shr(Ref type, Ref c, Ref arg) {
         }
     }
 
+    if (auto res = Simplify<id>::apply(Env(type), a, b)) return res;
+
     return world.raw_app(type, callee, {a, b});
 }
 
@@ -474,6 +536,8 @@ Ref normalize_wrap(Ref type, Ref c, Ref arg) {
     }
     // clang-format on
 
+    // if we rewrite, we have to forget about nsw/nuw
+    if (auto res = Simplify<id>::apply(Env(type, nat_t(Mode::none)), a, b)) return res;
     if (auto res = reassociate<wrap>(id, world, callee, a, b)) return res;
 
     return world.raw_app(type, callee, {a, b});
@@ -516,6 +580,8 @@ Ref normalize_div(Ref full_type, Ref c, Ref arg) {
         }
     }
 
+    if (auto res = Simplify<id>::apply(Env(type), a, b)) return make_res(res);
+
     return world.raw_app(full_type, callee, arg);
 }
 
@@ -542,19 +608,20 @@ Ref normalize_conv(Ref dst_t, Ref c, Ref x) {
             return world.lit(d_t, *l % *ld);
         }
 
-        auto sw = Idx::size2bitwidth(*ls);
-        auto dw = Idx::size2bitwidth(*ld);
-
-        // clang-format off
-        if (false) {}
-#define M(S, D) \
-        else if (S == sw && D == dw) return world.lit(d_t, w2s<D>(thorin::bitcast<w2s<S>>(*l)));
-        M( 1,  8) M( 1, 16) M( 1, 32) M( 1, 64)
-                  M( 8, 16) M( 8, 32) M( 8, 64)
-                            M(16, 32) M(16, 64)
-                                      M(32, 64)
-        else assert(false && "TODO: conversion between different Idx sizes");
-        // clang-format on
+        using F                  = u64 (*)(u64);
+        static constexpr auto sexts = width_table<std::array<F, Num_Widths>>([]<nat_t S>() {
+            return width_table<F>([]<nat_t D>() -> F {
+                if constexpr (S < D)
+                    return [](u64 l) { return u64(w2u<D>(w2s<D>(thorin::bitcast<w2s<S>>(l)))); };
+                else
+                    return nullptr;
+            });
+        });
+
+        auto sw = width2index(Idx::size2bitwidth(*ls));
+        auto dw = width2index(Idx::size2bitwidth(*ld));
+        if (sw && dw && sexts[*sw][*dw]) return world.lit(d_t, sexts[*sw][*dw](*l));
+        assert(false && "TODO: conversion between different Idx sizes");
     }
 
     return world.raw_app(dst_t, callee, x);
@@ -0,0 +1,238 @@
+#include "dialects/core/phases/dead_arg_elim.h"
+
+#include "dialects/core/core.h"
+#include "dialects/mem/mem.h"
+
+namespace thorin::core {
+
+namespace {
+
+bool has_dead(const std::vector<bool>& live) { return std::ranges::find(live, false) != live.end(); }
+
+/// Are all uses of the Lam::var of @p lam Extract%s with a literal index?
+bool only_extracts(Lam* lam) {
+    if (lam->num_vars() == 1) return true;
+    return std::ranges::all_of(lam->var()->uses(), [](Use use) {
+        auto extract = use->isa<Extract>();
+        return extract && Lit::isa(extract->index());
+    });
+}
+
+} // namespace
+
+/*
+ * analysis
+ */
+
+bool DeadArgElim::analyze() {
+    if (known_.empty()) collect();
+
+    bool todo = false;
+    cache_.clear();
+    for (auto& [lam, live] : live_) {
+        for (size_t i = 0, n = live.size(); i != n; ++i)
+            if (!live[i] && is_live(lam->var(n, i))) live[i] = todo = true;
+    }
+
+    if (!todo) finalize();
+    return todo;
+}
+
+void DeadArgElim::collect() {
+    unique_queue<DefSet> defs;
+    for (const auto& [_, mut] : world().externals()) defs.push(mut);
+    while (!defs.empty()) {
+        auto def = defs.pop();
+        if (auto lam = def->isa_mut<Lam>(); lam && is_known(lam)) known_.emplace(lam);
+        for (auto op : def->ops())
+            if (op) defs.push(op);
+    }
+
+    // Everything starts out dead but what we can't or don't want to drop.
+    auto init = [](Lam* lam, bool ret) {
+        auto n     = lam->num_vars();
+        auto whole = !only_extracts(lam);
+        auto live  = std::vector<bool>(n);
+        for (size_t i = 0; i != n; ++i) live[i] = whole || match<mem::M>(lam->dom(n, i)) || (ret && i == n - 1);
+        return live;
+    };
+
+    for (auto lam : known_) {
+        live_[lam] = init(lam, bool(lam->ret_var()));
+        if (auto ks = conts(lam)) {
+            ret2lam_[lam->ret_var()] = lam;
+            for (auto k : *ks) live_[k] = init(k, false);
+            conts_[lam] = std::move(*ks);
+        }
+    }
+}
+
+bool DeadArgElim::is_known(Lam* lam) {
+    if (lam->is_external() || !lam->is_set() || lam->type()->isa_mut() || lam->dom()->isa_mut()) return false;
+
+    bool called = false;
+    for (auto use : lam->uses()) {
+        if (use->isa<Var>()) continue;
+        if (!use->isa<App>() || use.index() != 0) return false;
+        called = true;
+    }
+    return called;
+}
+
+std::optional<LamSet> DeadArgElim::conts(Lam* lam) {
+    auto ret = lam->ret_var();
+    if (!ret || !only_extracts(lam) || lam->ret_pi()->dom()->isa_mut()) return {};
+
+    // Is @p use passing something as return continuation to lam?
+    auto n      = lam->num_vars();
+    auto passed = [lam, n](Use use) {
+        auto to_lam = [lam](Use u) {
+            auto app = u->isa<App>();
+            return app && u.index() == 1 && app->callee() == lam;
+        };
+        if (n == 1) return to_lam(use);
+        return use->isa<Tuple>() && use.index() == n - 1 && std::ranges::all_of(use->uses(), to_lam);
+    };
+
+    // The return continuation is either invoked or passed on by a recursive call.
+    for (auto use : ret->uses())
+        if (!(use->isa<App>() && use.index() == 0) && !passed(use)) return {};
+
+    auto res = LamSet();
+    for (auto use : lam->uses()) {
+        auto app = use->isa<App>();
+        if (!app) continue;
+
+        auto arg = app->arg(n, n - 1);
+        if (arg == ret) continue;
+
+        auto k = arg->isa_mut<Lam>();
+        if (!k || k->is_external() || !k->is_set() || k->dom()->isa_mut()) return {};
+        for (auto u : k->uses())
+            if (!u->isa<Var>() && !passed(u)) return {};
+        res.emplace(k);
+    }
+
+    if (res.empty()) return {};
+    return res;
+}
+
+/// A Def is live, if it is used in any way but - possibly indirectly via other immutables - as argument to a dead parameter.
+bool DeadArgElim::is_live(Ref def) {
+    if (def->isa_mut()) return true;
+    if (auto i = cache_.find(def); i != cache_.end()) return i->second;
+
+    bool res = false;
+    for (auto use : def->uses()) {
+        if (use.index() == Use::Type) {
+            res = true;
+        } else if (auto tuple = use->isa<Tuple>()) {
+            res = std::ranges::any_of(tuple->uses(),
+                                      [&](Use u) { return is_used(u, use.index(), tuple->num_ops()); });
+        } else {
+            res = is_used(use, 0, 1);
+        }
+        if (res) break;
+    }
+
+    return cache_[def] = res;
+}
+
+bool DeadArgElim::is_used(Use use, size_t i, size_t n) {
+    if (auto app = use->isa<App>(); app && use.index() == 1) {
+        if (auto lam = app->callee()->isa_mut<Lam>(); lam && known_.contains(lam))
+            return lam->num_vars() != n || live_[lam][i];
+
+        if (auto j = ret2lam_.find(app->callee()); j != ret2lam_.end()) {
+            return std::ranges::any_of(conts_[j->second],
+                                       [&](Lam* k) { return k->num_vars() != n || live_[k][i]; });
+        }
+    }
+
+    return is_live(use.def());
+}
+
+void DeadArgElim::finalize() {
+    for (auto lam : known_) {
+        if (const auto& live = live_[lam]; has_dead(live)) keep_[lam] = live;
+
+        if (auto i = conts_.find(lam); i != conts_.end()) {
+            auto m    = (*i->second.begin())->num_vars();
+            auto keep = std::vector<bool>(m);
+            for (auto k : i->second)
+                for (size_t j = 0; j != m; ++j) keep[j] = keep[j] || live_[k][j];
+
+            if (has_dead(keep)) {
+                for (auto k : i->second) keep_[k] = keep;
+                keep_ret_[lam] = std::move(keep);
+            }
+        }
+
+        if (keep_.contains(lam) || keep_ret_.contains(lam))
+            world().DLOG("{}: keep {} of {} vars", lam, std::ranges::count(live_[lam], true), lam->num_vars());
+    }
+}
+
+/*
+ * rewrite
+ */
+
+Ref DeadArgElim::rewrite_imm(Ref old_def) {
+    if (auto app = old_def->isa<App>()) {
+        const std::vector<bool>* keep = nullptr;
+        bool changed                  = false;
+        if (auto lam = app->callee()->isa_mut<Lam>()) {
+            if (auto i = keep_.find(lam); i != keep_.end()) keep = &i->second;
+            changed = keep || keep_ret_.contains(lam);
+        } else if (auto i = ret2lam_.find(app->callee()); i != ret2lam_.end()) {
+            if (auto j = keep_ret_.find(i->second); j != keep_ret_.end()) keep = &j->second;
+            changed = keep;
+        }
+
+        if (changed) {
+            auto n    = app->num_args();
+            auto args = DefVec();
+            for (size_t i = 0; i != n; ++i)
+                if (!keep || (*keep)[i]) args.emplace_back(rewrite(app->arg(n, i)));
+            return world().app(rewrite(app->callee()), args);
+        }
+    }
+
+    return RWPhase::rewrite_imm(old_def);
+}
+
+Ref DeadArgElim::rewrite_mut(Def* old_mut) {
+    auto old_lam = old_mut->isa<Lam>();
+    auto i       = old_lam ? keep_.find(old_lam) : keep_.end();
+    auto j       = old_lam ? keep_ret_.find(old_lam) : keep_ret_.end();
+    if (i == keep_.end() && j == keep_ret_.end()) return RWPhase::rewrite_mut(old_mut);
+
+    auto n    = old_lam->num_vars();
+    auto keep = [&](size_t k) { return i == keep_.end() || i->second[k]; };
+    auto doms = DefVec();
+    for (size_t k = 0; k != n; ++k) {
+        if (!keep(k)) continue;
+
+        if (j != keep_ret_.end() && k == n - 1) {
+            auto m        = j->second.size();
+            auto ret_doms = DefVec();
+            for (size_t l = 0; l != m; ++l)
+                if (j->second[l]) ret_doms.emplace_back(rewrite(old_lam->ret_pi()->dom(m, l)));
+            doms.emplace_back(world().cn(ret_doms));
+        } else {
+            doms.emplace_back(rewrite(old_lam->dom(n, k)));
+        }
+    }
+
+    auto m       = doms.size();
+    auto new_lam = old_lam->stub(world(), world().cn(doms));
+    map(old_lam, new_lam);
+    for (size_t k = 0, l = 0; k != n; ++k) {
+        auto old_var = old_lam->var(n, k);
+        map(old_var, keep(k) ? Ref(new_lam->var(m, l++)->set(old_var->dbg())) : world().bot(rewrite(old_var->type())));
+    }
+
+    return new_lam->set(rewrite(old_lam->filter()), rewrite(old_lam->body()));
+}
+
+} // namespace thorin::core
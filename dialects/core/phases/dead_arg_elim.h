@@ -0,0 +1,45 @@
+#pragma once
+
+#include <thorin/phase/phase.h>
+
+namespace thorin::core {
+
+/// Interprocedural dead argument and dead return elimination.
+/// A Lam is *known*, if it is internal and only used in callee position - i.e. all its call sites are visible.
+/// * The Pi of a known Lam shrinks by all of its *dead* parameters.
+///   A parameter is dead, if it is not used at all or only flows into dead parameters - e.g. by a recursive call.
+/// * The return continuation of a known Lam shrinks by all components that are dead in *all* continuations passed to it -
+///   provided that the return continuation is only invoked and each call site passes a Lam that serves no other purpose.
+///
+/// All call sites, invocations of the return continuation, and the continuations passed to it are adjusted
+/// accordingly. Parameters of type `%%mem.M` and return continuations themselves are always kept.
+class DeadArgElim : public FPPhase {
+public:
+    DeadArgElim(World& world)
+        : FPPhase(world, "dead_arg_elim") {}
+
+    bool analyze() override;
+    Ref rewrite_imm(Ref) override;
+    Ref rewrite_mut(Def*) override;
+
+private:
+    /// @name analysis
+    ///@{
+    void collect();
+    bool is_known(Lam*);
+    std::optional<LamSet> conts(Lam*); ///< Continuations passed to the Lam::ret_var or `std::nullopt` if unsuitable.
+    bool is_live(Ref);
+    bool is_used(Use, size_t i, size_t n); ///< Is the @p i-th of @p n components passed via this Use live?
+    void finalize();
+    ///@}
+
+    LamSet known_;
+    LamMap<LamSet> conts_;               ///< Known Lam ↦ all continuations passed as its return continuation.
+    DefMap<Lam*> ret2lam_;               ///< Lam::ret_var ↦ its known Lam, if the return continuation may shrink.
+    LamMap<std::vector<bool>> live_;     ///< Which Lam::var%s of known Lam%s and their continuations are live?
+    LamMap<std::vector<bool>> keep_;     ///< Which parameters to keep; only present, if some get dropped.
+    LamMap<std::vector<bool>> keep_ret_; ///< Which components of the return continuation to keep - as above.
+    DefMap<bool> cache_;                 ///< Memoizes is_live within one round of analyze.
+};
+
+} // namespace thorin::core
@@ -0,0 +1,300 @@
+#include "dialects/core/phases/sccp.h"
+
+#include "dialects/core/core.h"
+
+namespace thorin::core {
+
+namespace {
+
+/// Largest value of `.Idx s`, if @p type is an `.Idx` with literal size.
+std::optional<u64> idx_max(Ref type) {
+    if (auto size = Idx::size(type)) {
+        if (auto s = Lit::isa(size)) return *s == 0 ? u64(-1) : *s - 1;
+    }
+    return {};
+}
+
+} // namespace
+
+bool SCCP::analyze() {
+    if (lams_.empty()) {
+        for (const auto& [_, def] : world().annexes()) escape(def);
+        for (const auto& [_, mut] : world().externals()) escape(mut);
+    }
+
+    todo_ = false;
+    cache_.clear();
+    for (size_t i = 0; i != lams_.size(); ++i) visit(lams_[i]);
+    return todo_;
+}
+
+/*
+ * lattice
+ */
+
+SCCP::Val SCCP::eval(Ref def) {
+    if (auto i = cache_.find(def); i != cache_.end()) return i->second;
+    return cache_[def] = transfer(def);
+}
+
+SCCP::Val SCCP::transfer(Ref def) {
+    if (auto lam = def->isa_mut<Lam>()) return {Val::Const, lam};
+    if (def->isa_mut()) {
+        escape(def);
+        return {Val::Bot};
+    }
+    if (def->dep_const()) {
+        if (auto lit = def->isa<Lit>(); lit && idx_max(lit->type()))
+            return {Val::Range, nullptr, lit->get(), lit->get()};
+        return {Val::Const, def};
+    }
+
+    if (auto var = def->isa<Var>()) {
+        auto lam = var->mut()->isa_mut<Lam>();
+        if (!lam) return {Val::Bot};
+        if (lam->num_vars() == 1) return vars_[var];
+
+        // the whole Var is passed on
+        auto vals = std::vector<Val>();
+        auto ops  = DefVec();
+        for (size_t i = 0, e = lam->num_vars(); i != e; ++i) {
+            auto val = eval(lam->var(i));
+            if (val.tag == Val::Top) return val;
+            vals.emplace_back(val);
+            if (auto c = as_const(lam->var(i)->type(), val)) ops.emplace_back(c);
+        }
+        if (ops.size() == vals.size()) return {Val::Const, world().tuple(var->type(), ops)};
+        for (auto val : vals) lose(val);
+        return {Val::Bot};
+    } else if (auto extract = def->isa<Extract>()) {
+        auto var = extract->tuple()->isa<Var>();
+        if (auto lam = var ? var->mut()->isa_mut<Lam>() : nullptr;
+            lam && lam->num_vars() != 1 && Lit::isa(extract->index())) {
+            return vars_[extract];
+        } else if (auto tuple = extract->tuple()->isa<Tuple>()) {
+            // select: only join what is reachable via the index
+            auto range = bounds(extract->index());
+            if (!range) return {Val::Top};
+            auto res = Val();
+            for (u64 i = range->first, e = std::min(range->second, u64(tuple->num_ops() - 1)); i <= e; ++i)
+                res = join(extract->type(), res, eval(tuple->op(i)));
+            return res;
+        }
+    }
+
+    auto vals = std::vector<Val>();
+    auto ops  = DefVec();
+    for (auto op : def->ops()) {
+        auto val = eval(op);
+        if (val.tag == Val::Top) return val;
+        vals.emplace_back(val);
+        if (auto c = as_const(op->type(), val)) ops.emplace_back(c);
+    }
+
+    if (ops.size() == def->num_ops() && def->type()->dep_const()) {
+        if (auto new_def = def->rebuild(world(), def->type(), ops); new_def->dep_const()) return transfer(new_def);
+    }
+
+    for (auto val : vals) lose(val);
+
+    auto max = idx_max(def->type());
+    if (!max) return {Val::Bot};
+    auto range = [&](u64 lo, u64 hi) {
+        return lo == 0 && hi == *max ? Val{Val::Bot} : Val{Val::Range, nullptr, lo, hi};
+    };
+
+    if (auto cmp = match<icmp>(def)) {
+        auto [a, b] = cmp->args<2>();
+        auto ra     = bounds(a);
+        auto rb     = bounds(b);
+        auto amax   = idx_max(a->type());
+        if (!ra || !rb || !amax) return {Val::Bot};
+
+        // Which of the relations X, Y, G, L, E are possible? See %core.icmp.
+        auto [alo, ahi] = *ra;
+        auto [blo, bhi] = *rb;
+        auto h          = *amax / 2 + 1; // first minus
+        bool yes = false, no = false;
+        auto rel = [&](icmp r, bool possible) {
+            if (possible) (((cmp.id() & r) != icmp::f) ? yes : no) = true;
+        };
+        // greater/less with same sign within [lo, hi]
+        auto greater = [](u64 alo, u64 ahi, u64 blo, u64 bhi) { return alo <= ahi && blo <= bhi && ahi > blo; };
+        rel(icmp::Xygle, alo < h && bhi >= h);
+        rel(icmp::xYgle, ahi >= h && blo < h);
+        rel(icmp::xyGle, greater(alo, std::min(ahi, h - 1), blo, std::min(bhi, h - 1))
+                             || greater(std::max(alo, h), ahi, std::max(blo, h), bhi));
+        rel(icmp::xygLe, greater(blo, std::min(bhi, h - 1), alo, std::min(ahi, h - 1))
+                             || greater(std::max(blo, h), bhi, std::max(alo, h), ahi));
+        rel(icmp::xyglE, alo <= bhi && blo <= ahi);
+        return range(yes && !no ? 1 : 0, no && !yes ? 0 : 1);
+    }
+
+    if (auto wrap = match<core::wrap>(def)) {
+        auto [a, b] = wrap->args<2>();
+        auto ra     = bounds(a);
+        auto rb     = bounds(b);
+        if (!ra || !rb) return {Val::Bot};
+        auto [alo, ahi] = *ra;
+        auto [blo, bhi] = *rb;
+        switch (wrap.id()) {
+            case wrap::add:
+                if (bhi <= *max - ahi) return range(alo + blo, ahi + bhi);
+                break;
+            case wrap::sub:
+                if (alo >= bhi) return range(alo - bhi, ahi - blo);
+                break;
+            case wrap::mul:
+                if (ahi == 0 || bhi <= *max / ahi) return range(alo * blo, ahi * bhi);
+                break;
+            case wrap::shl:
+                if (blo == bhi && blo < 64 && ahi <= *max >> blo) return range(alo << blo, ahi << blo);
+                break;
+            default: break;
+        }
+    } else if (auto bit = match(bit2::and_, def)) {
+        auto [a, b] = bit->args<2>();
+        if (auto ra = bounds(a), rb = bounds(b); ra && rb) return range(0, std::min(ra->second, rb->second));
+    } else if (auto shr = match(shr::l, def)) {
+        auto [a, b] = shr->args<2>();
+        auto ra     = bounds(a);
+        auto rb     = bounds(b);
+        if (ra && rb && rb->first == rb->second && rb->first < 64)
+            return range(ra->first >> rb->first, ra->second >> rb->first);
+    } else if (auto conv = match(conv::u, def)) {
+        if (auto ra = bounds(conv->arg()); ra && ra->second <= *max) return range(ra->first, ra->second);
+    }
+
+    return {Val::Bot};
+}
+
+SCCP::Val SCCP::join(Ref type, Val a, Val b) {
+    if (a.tag == Val::Top || a == b) return b;
+    if (b.tag == Val::Top) return a;
+
+    if (a.tag == Val::Range && b.tag == Val::Range) {
+        auto lo = std::min(a.lo, b.lo), hi = std::max(a.hi, b.hi);
+        if (auto max = idx_max(type); max && (lo != 0 || hi != *max)) return {Val::Range, nullptr, lo, hi};
+    }
+
+    lose(a);
+    lose(b);
+    return {Val::Bot};
+}
+
+std::optional<std::pair<u64, u64>> SCCP::bounds(Ref def) {
+    auto val = eval(def);
+    if (val.tag == Val::Top) return {};
+    if (val.tag == Val::Range) return std::pair(val.lo, val.hi);
+    return std::pair(u64(0), idx_max(def->type()).value_or(u64(-1)));
+}
+
+Ref SCCP::as_const(Ref type, Val val) {
+    if (val.tag == Val::Range && val.lo == val.hi) return world().lit(type, val.lo);
+    if (val.tag == Val::Const && val.def->dep_const()) return val.def;
+    return nullptr;
+}
+
+/*
+ * reachability
+ */
+
+void SCCP::visit(Lam* lam) {
+    auto app = lam->body() ? lam->body()->isa<App>() : nullptr;
+    if (!app) {
+        if (lam->body()) lose(eval(lam->body()));
+        return;
+    }
+
+    auto callees = targets(app->callee());
+    if (!callees) {
+        // e.g. a branch to an unknown continuation: all Lam%s the callee may select escape
+        escape(app->callee());
+        lose(eval(app->arg()));
+        return;
+    }
+
+    for (auto callee : *callees) {
+        if (!callee->is_set()) {
+            lose(eval(app->arg()));
+            continue;
+        }
+
+        reach(callee);
+        auto n = callee->num_vars();
+        for (size_t i = 0; i != n; ++i) set(callee->var(i), eval(app->arg()->proj(n, i)));
+    }
+}
+
+std::optional<LamSet> SCCP::targets(Ref callee) {
+    if (auto extract = callee->isa<Extract>()) {
+        if (auto tuple = extract->tuple()->isa<Tuple>()) {
+            auto range = bounds(extract->index());
+            if (!range) return LamSet();
+
+            auto res = LamSet();
+            for (u64 i = range->first, e = std::min(range->second, u64(tuple->num_ops() - 1)); i <= e; ++i) {
+                auto lam = tuple->op(i)->isa_mut<Lam>();
+                if (!lam) return {};
+                res.emplace(lam);
+            }
+            return res;
+        }
+    }
+
+    auto val = eval(callee);
+    if (val.tag == Val::Top) return LamSet();
+    if (val.tag == Val::Const) {
+        if (auto lam = val.def->isa_mut<Lam>()) {
+            auto res = LamSet();
+            res.emplace(lam);
+            return res;
+        }
+    }
+    return {};
+}
+
+void SCCP::set(Ref var, Val val) {
+    auto old = vars_[var];
+    auto res = join(var->type(), old, val);
+    if (res == old) return;
+    if (res.tag == Val::Range && ++widen_[var] > Max_Widen) res = {Val::Bot};
+    vars_[var] = res;
+    todo_      = true;
+}
+
+void SCCP::reach(Lam* lam) {
+    if (reached_.emplace(lam).second) {
+        lams_.emplace_back(lam);
+        todo_ = true;
+    }
+}
+
+/// Called from unknown places: all Lam%s within @p def are reachable and their Var%s are ⊥.
+void SCCP::escape(Ref def) {
+    if (!def || !escaped_.emplace(def).second) return;
+
+    if (auto lam = def->isa_mut<Lam>()) {
+        reach(lam);
+        for (size_t i = 0, e = lam->num_vars(); i != e; ++i) set(lam->var(i), {Val::Bot});
+    } else if (!def->isa<Var>() && !def->dep_const()) {
+        for (auto op : def->ops()) escape(op);
+    }
+}
+
+/*
+ * rewrite
+ */
+
+Ref SCCP::rewrite_imm(Ref old_def) {
+    if (auto i = cache_.find(old_def); i != cache_.end()) {
+        if (auto new_def = as_const(old_def->type(), i->second); new_def && new_def != old_def) {
+            world().DLOG("{} ↦ {}", old_def, new_def);
+            return new_def;
+        }
+    }
+
+    return RWPhase::rewrite_imm(old_def);
+}
+
+} // namespace thorin::core
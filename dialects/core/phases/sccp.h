@@ -0,0 +1,72 @@
+#pragma once
+
+#include <thorin/phase/phase.h>
+
+namespace thorin::core {
+
+/// Interprocedural
+/// [Sparse Conditional Constant Propagation](https://en.wikipedia.org/wiki/Sparse_conditional_constant_propagation).
+/// Starting from the World::externals, all *reachable* Lam%s are analyzed while each Var is associated with a value of
+/// the following lattice:
+/// ```
+///              ⊤                 not reached (yet)
+///    ... [l, h] ... constant ... range of an `.Idx s` (a literal if `l == h`) or any other constant
+///              ⊥                 unknown
+/// ```
+/// Arguments of all call sites are joined into the Var%s of the callee.
+/// Branches `(f, g)#i` only reach what the range of `i` permits; this also holds for `select`s of values.
+/// Continuations that are passed as arguments are tracked as constants as well such that return values flow back to
+/// the caller.
+/// Lam%s that are called from unknown places *escape* and their Var%s receive ⊥.
+/// Afterwards, all Def%s that turned out to be constant are replaced and the normalizers take it from there.
+/// In particular, this specializes callees whose arguments are constant at all call sites.
+class SCCP : public FPPhase {
+public:
+    static constexpr unsigned Max_Widen = 3; ///< Number of times a range may grow before it is widened to ⊥.
+
+    SCCP(World& world)
+        : FPPhase(world, "sccp") {}
+
+    bool analyze() override;
+    Ref rewrite_imm(Ref) override;
+
+private:
+    struct Val {
+        enum Tag : u8 { Top, Range, Const, Bot } tag = Top;
+        const Def* def = nullptr; ///< If Const: a closed Def or a Lam.
+        u64 lo = 0, hi = 0;       ///< If Range.
+
+        bool operator==(const Val&) const = default;
+    };
+
+    /// @name lattice
+    ///@{
+    Val eval(Ref);
+    Val transfer(Ref);
+    Val join(Ref type, Val, Val);
+    std::optional<std::pair<u64, u64>> bounds(Ref); ///< Range of the `.Idx` @p def or `std::nullopt` if ⊤.
+    Ref as_const(Ref type, Val);
+    ///@}
+
+    /// @name reachability
+    ///@{
+    void visit(Lam*);
+    std::optional<LamSet> targets(Ref callee); ///< Possible callees or `std::nullopt` if unknown.
+    void set(Ref var, Val);
+    void reach(Lam*);
+    void escape(Ref);
+    void lose(Val val) {
+        if (val.tag == Val::Const) escape(val.def);
+    }
+    ///@}
+
+    DefMap<Val> vars_;     ///< Lattice value of each Lam::var.
+    DefMap<Val> cache_;    ///< Lattice value of each immutable Def - recomputed in each round.
+    DefMap<unsigned> widen_;
+    std::vector<Lam*> lams_; ///< Reachable Lam%s.
+    LamSet reached_;
+    DefSet escaped_;
+    bool todo_ = false;
+};
+
+} // namespace thorin::core
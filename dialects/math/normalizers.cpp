@@ -1,5 +1,7 @@
 #include <type_traits>
 
+#include "thorin/rule.h"
+
 #include "dialects/math/math.h"
 
 namespace thorin::math {
@@ -102,17 +104,15 @@ Ref fold(World& world, Ref type, const Def* a) {
     auto la = a->isa<Lit>();
 
     if (la) {
-        nat_t width = *isa_f(a->type());
-        Res res;
-        switch (width) {
-#define CODE(i) \
-    case i: res = fold<Id, i>(la->get()); break;
-            THORIN_16_32_64(CODE)
-#undef CODE
-            default: unreachable();
-        }
-
-        return world.lit(type, *res);
+        using F                = Res (*)(u64);
+        static constexpr auto folds = width_table<F>([]<nat_t w>() -> F {
+            if constexpr (w >= 16)
+                return &fold<Id, w>;
+            else
+                return nullptr;
+        });
+
+        return world.lit(type, *folds[*width2index(*isa_f(a->type()))](la->get()));
     }
 
     return nullptr;
@@ -163,17 +163,15 @@ Ref fold(World& world, Ref type, const Def* a) {
     if (a->isa<Bot>()) return world.bot(type);
 
     if (auto la = Lit::isa(a)) {
-        nat_t width = *isa_f(a->type());
-        Res res;
-        switch (width) {
-#define CODE(i) \
-    case i: res = fold<Id, id, i>(*la); break;
-            THORIN_16_32_64(CODE)
-#undef CODE
-            default: unreachable();
-        }
-
-        return world.lit(type, *res);
+        using F                = Res (*)(u64);
+        static constexpr auto folds = width_table<F>([]<nat_t w>() -> F {
+            if constexpr (w >= 16)
+                return &fold<Id, id, w>;
+            else
+                return nullptr;
+        });
+
+        return world.lit(type, *folds[*width2index(*isa_f(a->type()))](*la));
     }
 
     return nullptr;
@@ -186,17 +184,15 @@ Ref fold(World& world, Ref type, const Def*& a, const Def*& b) {
 
     if (auto la = Lit::isa(a)) {
         if (auto lb = Lit::isa(b)) {
-            nat_t width = *isa_f(a->type());
-            Res res;
-            switch (width) {
-#define CODE(i) \
-    case i: res = fold<Id, id, i>(*la, *lb); break;
-                THORIN_16_32_64(CODE)
-#undef CODE
-                default: unreachable();
-            }
-
-            return world.lit(type, *res);
+            using F                = Res (*)(u64, u64);
+            static constexpr auto folds = width_table<F>([]<nat_t w>() -> F {
+                if constexpr (w >= 16)
+                    return &fold<Id, id, w>;
+                else
+                    return nullptr;
+            });
+
+            return world.lit(type, *folds[*width2index(*isa_f(a->type()))](*la, *lb));
         }
     }
 
@@ -261,6 +257,85 @@ Res fold(u64 a) {
     return D(bitcast<S>(a));
 }
 
+/*
+ * Rules
+ */
+
+using namespace rule;
+
+/// Splits the Lit of type `%%math.F (p, e)` into sign, exponent, and mantissa.
+struct Float {
+    Float(Ref lit) {
+        auto pe   = match<F>(lit->type())->arg();
+        auto bits = Lit::as(lit);
+        p         = Lit::as(pe->proj(2, 0));
+        e         = Lit::as(pe->proj(2, 1));
+        sign      = bits & (1_u64 << (p + e));
+        exponent  = (bits >> p) & ((1_u64 << e) - 1);
+        mantissa  = bits & ((1_u64 << p) - 1);
+    }
+
+    u64 bias() const { return (1_u64 << (e - 1)) - 1; }
+
+    nat_t p, e;
+    u64 sign, exponent, mantissa;
+};
+
+/// Matches a Lit whose reciprocal is exact - i.e. a power of two whose reciprocal is a normal number as well.
+template<size_t I>
+struct ExactRecip {
+    static bool match(Env& env, Ref def) {
+        if (!def->isa<Lit>()) return false;
+        auto f = Float(def);
+        return f.mantissa == 0 && f.exponent != 0 && f.exponent < 2 * f.bias() && env.bind(I, def);
+    }
+};
+
+/// Reciprocal of the Lit bound to @p I, which must be an ExactRecip.
+template<size_t I>
+struct Recip {
+    static Ref build(const Env& env) {
+        auto f = Float(env[I]);
+        return env.world().lit(env[I]->type(), f.sign | ((2 * f.bias() - f.exponent) << f.p));
+    }
+};
+
+/// Negation of the Lit bound to @p I.
+template<size_t I>
+struct Neg {
+    static Ref build(const Env& env) {
+        auto f = Float(env[I]);
+        return env.world().lit(env[I]->type(), env.lit(I) ^ (1_u64 << (f.p + f.e)));
+    }
+};
+
+// clang-format off
+template<class A, class B> using Add = Op<arith::add, A, B>;
+template<class A, class B> using Sub = Op<arith::sub, A, B>;
+template<class A, class B> using Mul = Op<arith::mul, A, B>;
+template<class A, class B> using Div = Op<arith::div, A, B>;
+
+/// Rules that apply after folding and commuting - i.e. a Lit operand of a commutative operation is on the left.
+template<auto id> struct Simplify : Rules<> {};
+
+template<> struct Simplify<arith::add> : Rules<
+    // c0 + (c1 + x) -> (c0 + c1) + x
+    Rule<Add<Const<0>, Add<Const<1>, Any<2>>>, Add<Add<Const<0>, Const<1>>, Any<2>>, Has<Mode::reassoc>>
+> {};
+template<> struct Simplify<arith::sub> : Rules<
+    // x - c -> -c + x
+    Rule<Sub<Any<0>, Const<1>>, Add<Neg<1>, Any<0>>>
+> {};
+template<> struct Simplify<arith::mul> : Rules<
+    // c0 * (c1 * x) -> (c0 * c1) * x
+    Rule<Mul<Const<0>, Mul<Const<1>, Any<2>>>, Mul<Mul<Const<0>, Const<1>>, Any<2>>, Has<Mode::reassoc>>
+> {};
+template<> struct Simplify<arith::div> : Rules<
+    // x / 2^k -> 2^-k * x
+    Rule<Div<Any<0>, ExactRecip<1>>, Mul<Recip<1>, Any<0>>>
+> {};
+// clang-format on
+
 } // namespace
 
 template<arith id>
@@ -323,6 +398,7 @@ Ref normalize_arith(Ref type, Ref c, Ref arg) {
     }
     // clang-format on
 
+    if (auto res = Simplify<id>::apply(Env(type, lm.value_or(0)), a, b)) return res;
     if (auto res = reassociate<arith>(id, world, callee, a, b)) return res;
 
     return world.raw_app(type, callee, {a, b});
@@ -426,29 +502,21 @@ Ref normalize_conv(Ref dst_t, Ref c, Ref x) {
         auto sw               = sf ? isa_f(s_t) : Idx::size2bitwidth(*ls);
         auto dw               = df ? isa_f(d_t) : Idx::size2bitwidth(*ld);
 
-        if (sw && dw) {
-            Res res;
-            // clang-format off
-            if (false) {}
-#define M(S, D)                                         \
-            else if (S == *sw && D == *dw) {            \
-                if constexpr (S >= min_s && D >= min_d) \
-                    res = fold<conv, id, S, D>(*l);     \
-                else                                    \
-                    goto out;                           \
-            }
-            M( 1,  1) M( 1,  8) M( 1, 16) M( 1, 32) M( 1, 64)
-            M( 8,  1) M( 8,  8) M( 8, 16) M( 8, 32) M( 8, 64)
-            M(16,  1) M(16,  8) M(16, 16) M(16, 32) M(16, 64)
-            M(32,  1) M(32,  8) M(32, 16) M(32, 32) M(32, 64)
-            M(64,  1) M(64,  8) M(64, 16) M(64, 32) M(64, 64)
-
-            else unreachable();
-            // clang-format on
-            return world.lit(d_t, *res);
-        }
+        using F                  = Res (*)(u64);
+        static constexpr auto folds = width_table<std::array<F, Num_Widths>>([]<nat_t S>() {
+            return width_table<F>([]<nat_t D>() -> F {
+                if constexpr (S >= min_s && D >= min_d)
+                    return &fold<conv, id, S, D>;
+                else
+                    return nullptr;
+            });
+        });
+
+        auto si = sw ? width2index(*sw) : std::nullopt;
+        auto di = dw ? width2index(*dw) : std::nullopt;
+        if (si && di && folds[*si][*di]) return world.lit(d_t, *folds[*si][*di](*l));
     }
-out:
+
     return world.raw_app(dst_t, callee, x);
 }
 
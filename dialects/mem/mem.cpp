@@ -12,7 +12,9 @@
 #include "dialects/mem/passes/rw/alloc2malloc.h"
 #include "dialects/mem/passes/rw/remem_elim.h"
 #include "dialects/mem/passes/rw/reshape.h"
+#include "dialects/mem/passes/rw/sroa.h"
 #include "dialects/mem/phases/rw/add_mem.h"
+#include "dialects/mem/phases/rw/loop_opt.h"
 
 using namespace thorin;
 
@@ -22,6 +24,7 @@ extern "C" THORIN_EXPORT Plugin thorin_get_plugin() {
                 register_pass_with_arg<mem::ssa_pass, mem::SSAConstr, EtaExp>(passes);
                 register_pass<mem::remem_elim_pass, mem::RememElim>(passes);
                 register_pass<mem::alloc2malloc_pass, mem::Alloc2Malloc>(passes);
+                register_pass<mem::sroa_pass, mem::SROA>(passes);
 
                 // TODO: generalize register_pass_with_arg
                 passes[flags_t(Annex::Base<mem::copy_prop_pass>)]
@@ -42,6 +45,7 @@ extern "C" THORIN_EXPORT Plugin thorin_get_plugin() {
                           builder.add_pass<mem::Reshape>(app, mode);
                       };
                 register_pass<mem::add_mem_pass, mem::AddMemWrapper>(passes);
+                register_phase<mem::loop_opt_phase, mem::LoopOpt>(passes);
             },
             nullptr};
 }
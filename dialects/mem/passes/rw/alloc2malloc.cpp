@@ -7,14 +7,104 @@ namespace thorin::mem {
 Ref Alloc2Malloc::rewrite(Ref def) {
     if (auto alloc = match<mem::alloc>(def)) {
         auto [pointee, addr_space] = alloc->decurry()->args<2>();
+        if (!escapes(def)) {
+            world().DLOG("place non-escaping allocation '{}' on the stack", alloc);
+            auto slot = op_mslot(pointee, alloc->arg(), world().lit_nat(world().curr_gid()));
+            stack_.emplace(slot);
+            return slot;
+        }
         return op_malloc(pointee, alloc->arg());
     } else if (auto slot = match<mem::slot>(def)) {
         auto [pointee, addr_space] = slot->decurry()->args<2>();
         auto [mem, id]             = slot->args<2>();
         return op_mslot(pointee, mem, id);
+    } else if (auto free = match<mem::free>(def)) {
+        auto [mem, ptr] = free->args<2>();
+        if (auto extract = ptr->isa<Extract>(); extract && stack_.contains(extract->tuple())) return mem;
     }
 
     return def;
 }
 
+/// Only small, statically sized allocations in the body of a function - and not in a basic block that might be part of
+/// a loop - are considered. Conservatively, the surrounding function must not contain nested functions that might
+/// capture it.
+bool Alloc2Malloc::escapes(Ref alloc) {
+    auto lam = curr_mut();
+    if (!Lam::isa_returning(lam)) return true;
+
+    auto [pointee, addr_space] = match<mem::alloc, false>(alloc)->decurry()->args<2>();
+    auto size                  = Lit::isa(world().call(core::trait::size, pointee));
+    if (!size || *size > Max_Stack_Size) return true;
+
+    if (!scope_ || scope_->entry() != lam) scope_ = std::make_unique<Scope>(lam);
+    if (!scope_->bound(alloc)) return true; // freshly rebuilt: we don't know its users yet
+    for (auto def : scope_->bound())
+        if (auto nested = def->isa_mut<Lam>(); nested && nested != lam && !Lam::isa_basicblock(nested)) return true;
+
+    DefSet done;
+    for (auto use : alloc->uses()) {
+        if (!scope_->bound(use)) continue;
+        auto extract = use->isa<Extract>();
+        if (!extract) return true;
+        if (match<mem::Ptr>(extract->type()) && escapes(extract, true, done)) return true;
+    }
+
+    return false;
+}
+
+/// Does @p ptr possibly outlive the current function?
+/// We follow loads, stores, `lea`s, and basic blocks that receive @p ptr as argument.
+/// A `free` is only fine on the @p direct result of the allocation, as it is removed afterwards.
+/// All other uses are considered to escape.
+bool Alloc2Malloc::escapes(Ref ptr, bool direct, DefSet& done) {
+    if (!done.emplace(ptr).second) return false;
+
+    // Does the `i`-th of `n` arguments escape in the basic block `callee`?
+    auto escapes_bb = [&](Ref callee, size_t n, size_t i) {
+        auto bb = callee->isa_mut<Lam>();
+        if (!bb || !Lam::isa_basicblock(bb) || bb->num_vars() != n) return true;
+        if (n == 1) return escapes(bb->var(), false, done);
+
+        for (auto use : bb->var()->uses()) {
+            if (!scope_->bound(use)) continue;
+            auto extract = use->isa<Extract>();
+            auto index   = extract ? Lit::isa(extract->index()) : std::nullopt;
+            if (!index) return true; // the whole var is passed on
+            if (*index == i && escapes(extract, false, done)) return true;
+        }
+        return false;
+    };
+
+    for (auto use : ptr->uses()) {
+        if (!scope_->bound(use)) continue;
+
+        if (auto app = use->isa<App>(); app && use.index() == 1) {
+            if (escapes_bb(app->callee(), 1, 0)) return true;
+        } else if (auto tuple = use->isa<Tuple>()) {
+            auto i = use.index();
+            for (auto tuple_use : tuple->uses()) {
+                if (!scope_->bound(tuple_use)) continue;
+
+                auto app = tuple_use->isa<App>();
+                if (!app || tuple_use.index() != 1) return true;
+
+                if (match<mem::load>(app) || match<mem::store>(app)) {
+                    if (i != 1) return true; // storing the pointer itself lets it escape
+                } else if (match<mem::free>(app)) {
+                    if (i != 1 || !direct) return true;
+                } else if (match<mem::lea>(app)) {
+                    if (i != 0 || escapes(app, false, done)) return true;
+                } else if (escapes_bb(app->callee(), tuple->num_ops(), i)) {
+                    return true;
+                }
+            }
+        } else {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 } // namespace thorin::mem
@@ -1,15 +1,31 @@
 #pragma once
 
+#include <memory>
+
+#include "thorin/analyses/scope.h"
 #include "thorin/pass/pass.h"
 
 namespace thorin::mem {
 
+/// Lowers `%mem.alloc` to `%mem.malloc` and `%mem.slot` to `%mem.mslot`.
+/// An allocation within the body of a function whose pointer provably does not escape this function is placed on the
+/// stack (`%mem.mslot`) instead; a `%mem.free` of such a pointer is removed.
 class Alloc2Malloc : public RWPass<Alloc2Malloc, Lam> {
 public:
+    /// Larger (or dynamically sized) allocations always go to the heap.
+    static constexpr nat_t Max_Stack_Size = 4096;
+
     Alloc2Malloc(PassMan& man)
         : RWPass(man, "alloc2malloc") {}
 
     Ref rewrite(Ref) override;
+
+private:
+    bool escapes(Ref alloc);
+    bool escapes(Ref ptr, bool direct, DefSet& done);
+
+    std::unique_ptr<Scope> scope_;
+    DefSet stack_;
 };
 
 } // namespace thorin::mem
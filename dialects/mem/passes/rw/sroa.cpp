@@ -0,0 +1,68 @@
+#include "dialects/mem/passes/rw/sroa.h"
+
+#include "dialects/mem/mem.h"
+
+namespace thorin::mem {
+
+Ref SROA::rewrite(Ref def) {
+    if (auto slot = match<mem::slot>(def)) {
+        if (!splittable(def)) return def;
+
+        auto [pointee, addr_space] = slot->decurry()->args<2>();
+        auto n                     = Lit::as(pointee->arity());
+        auto mem                   = slot->arg(0);
+        world().DLOG("split slot '{}' into {} slots", slot, n);
+
+        DefArray ptrs(n);
+        for (size_t i = 0; i != n; ++i) {
+            auto elem = world().app(world().annex<mem::slot>(), {pointee->proj(n, i), addr_space});
+            auto res  = world().app(elem, {mem, world().lit_nat(world().curr_gid())});
+            mem       = res->proj(2, 0);
+            ptrs[i]   = res->proj(2, 1);
+        }
+
+        return world().tuple({mem, proxy(def->proj(2, 1)->type(), ptrs)});
+    } else if (auto lea = match<mem::lea>(def)) {
+        auto [ptr, index] = lea->args<2>();
+        if (auto proxy = isa_proxy(ptr)) return proxy->op(Lit::as(index));
+    }
+
+    return def;
+}
+
+/// Only statically shaped, non-dependent aggregates with at most Max_Elems elements are considered.
+/// The pointer of the slot must only be used as the first argument of `%mem.lea`s with a literal index - in particular,
+/// the aggregate as a whole must neither be loaded nor stored nor passed anywhere.
+bool SROA::splittable(Ref slot) {
+    auto [pointee, addr_space] = match<mem::slot, false>(slot)->decurry()->args<2>();
+    if (pointee->isa_mut() || (!pointee->isa<Sigma>() && !pointee->isa<Arr>())) return false;
+
+    auto n = Lit::isa(pointee->arity());
+    if (!n || *n <= 1 || *n > Max_Elems) return false;
+
+    if (!scope_) scope_ = std::make_unique<Scope>(curr_mut());
+    if (!scope_->bound(slot)) return false; // freshly rebuilt: we don't know its users yet
+
+    for (auto use : slot->uses()) {
+        if (!scope_->bound(use)) continue;
+        auto extract = use->isa<Extract>();
+        if (!extract) return false;
+        if (!match<mem::Ptr>(extract->type())) continue;
+
+        for (auto ptr_use : extract->uses()) {
+            if (!scope_->bound(ptr_use)) continue;
+            auto tuple = ptr_use->isa<Tuple>();
+            if (!tuple || ptr_use.index() != 0 || !Lit::isa(tuple->op(1))) return false;
+
+            for (auto tuple_use : tuple->uses()) {
+                if (!scope_->bound(tuple_use)) continue;
+                auto app = tuple_use->isa<App>();
+                if (!app || tuple_use.index() != 1 || !match<mem::lea>(app)) return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace thorin::mem
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include "thorin/analyses/scope.h"
+#include "thorin/pass/pass.h"
+
+namespace thorin::mem {
+
+/// Scalar Replacement of Aggregates:
+/// Splits a `%mem.slot` of Sigma or Arr type into one `%mem.slot` per element - provided that the slot is only accessed
+/// via `%mem.lea`s with literal indices.
+/// Each of these `%mem.lea`s then directly yields the pointer of its element's slot which in turn enables SSAConstr to
+/// promote the elements to SSA values.
+class SROA : public RWPass<SROA, Lam> {
+public:
+    /// Aggregates with more elements stay in memory.
+    static constexpr nat_t Max_Elems = 16;
+
+    SROA(PassMan& man)
+        : RWPass(man, "sroa") {}
+
+    void enter() override { scope_.reset(); }
+    Ref rewrite(Ref) override;
+
+private:
+    bool splittable(Ref slot);
+
+    std::unique_ptr<Scope> scope_;
+};
+
+} // namespace thorin::mem
@@ -0,0 +1,396 @@
+#include "dialects/mem/phases/rw/loop_opt.h"
+
+#include <thorin/rewrite.h>
+
+#include <thorin/analyses/domtree.h>
+
+#include "dialects/core/core.h"
+#include "dialects/mem/mem.h"
+
+namespace thorin::mem {
+
+namespace {
+
+using Base = LoopTree<true>::Base;
+using Head = LoopTree<true>::Head;
+using Leaf = LoopTree<true>::Leaf;
+
+/// An induction variable `H.var(i)` that is incremented by `steps[k]` along the `k`-th back-edge.
+struct IV {
+    size_t i;
+    DefVec steps;
+    bool no_wrap; ///< Do the increments provably never wrap around?
+};
+
+/// Either `iv * factor` or - if @p factor is `nullptr` - `lea(ptr, iv)`.
+struct Reduced {
+    Ref def;
+    size_t iv; ///< Index into the IV%s.
+    Ref factor;
+};
+
+/// Rewrites the Lam%s of a loop in place.
+class LoopRewriter : public Rewriter {
+public:
+    LoopRewriter(World& world, Lam* new_header, size_t n)
+        : Rewriter(world)
+        , new_header_(new_header)
+        , n_(n) {}
+
+    Ref rewrite(Ref old_def) override {
+        if (!old_def || old_def->dep_const()) return old_def;
+        return Rewriter::rewrite(old_def);
+    }
+
+    Ref rewrite_mut(Def* mut) override { return mut; }
+
+    Ref rewrite_imm(Ref old_def) override {
+        if (auto i = loads_.find(old_def); i != loads_.end())
+            return world().tuple({rewrite(old_def->as<App>()->arg(0)), i->second});
+
+        if (auto i = back_edges_.find(old_def); i != back_edges_.end()) {
+            auto app  = old_def->as<App>();
+            auto args = DefVec();
+            for (size_t j = 0; j != n_; ++j) args.emplace_back(rewrite(app->arg()->proj(n_, j)));
+            for (auto arg : i->second) args.emplace_back(rewrite(arg));
+            return world().app(new_header_, args);
+        }
+
+        return Rewriter::rewrite_imm(old_def);
+    }
+
+    DefMap<Ref> loads_;         ///< Hoisted `%%mem.load` ↦ its value.
+    DefMap<DefVec> back_edges_; ///< Back-edge ↦ additional arguments for the new header (yet to be rewritten).
+
+private:
+    Lam* new_header_;
+    size_t n_;
+};
+
+/// Collects all loop Head%s below @p node - inner loops first.
+void collect_heads(const Base* node, std::vector<const Head*>& heads) {
+    if (auto head = node->isa<Head>()) {
+        for (const auto& child : head->children()) collect_heads(child.get(), heads);
+        if (!head->is_root()) heads.emplace_back(head);
+    }
+}
+
+/// Collects all Lam%s of the loop @p node.
+void collect_lams(const Base* node, LamSet& lams) {
+    if (auto head = node->isa<Head>()) {
+        for (const auto& child : head->children()) collect_lams(child.get(), lams);
+    } else if (auto lam = node->as<Leaf>()->cf_node()->mut()->isa_mut<Lam>()) {
+        lams.emplace(lam);
+    }
+}
+
+bool has_mem(Ref type) {
+    if (match<mem::M>(type)) return true;
+    if (auto sigma = type->isa<Sigma>()) {
+        for (auto op : sigma->ops())
+            if (has_mem(op)) return true;
+    }
+    return false;
+}
+
+/// Does `%%core.conv.u` from `.Idx` @p src to `.Idx` @p dst preserve all values?
+bool widens(Ref src, Ref dst) {
+    auto s = Idx::size(src), d = Idx::size(dst);
+    if (d->isa<Top>()) return true;
+    auto ls = Lit::isa(s), ld = Lit::isa(d);
+    return ls && ld && (*ld == 0 || (*ls != 0 && *ls <= *ld));
+}
+
+/// Is @p ptr always dereferenceable such that loading from it may be speculated?
+/// We only accept statically sized slots and allocations - possibly offset by `%%mem.lea`s into a literal arity.
+bool dereferenceable(Ref ptr) {
+    while (auto lea = match<mem::lea>(ptr)) {
+        ptr               = lea->arg(0);
+        auto [pointee, _] = force<Ptr>(ptr->type())->args<2>();
+        if (!Lit::isa(pointee->arity())) return false;
+    }
+
+    auto extract = ptr->isa<Extract>();
+    if (!extract) return false;
+
+    auto pointee = [](Ref def) -> Ref {
+        if (auto alloc = match<mem::alloc>(def)) return alloc->decurry()->arg(0);
+        if (auto slot = match<mem::slot>(def)) return slot->decurry()->arg(0);
+        if (auto mslot = match<mem::mslot>(def)) return mslot->decurry()->arg(0);
+        return nullptr;
+    }(extract->tuple());
+
+    return pointee && Lit::isa(ptr->world().call(core::trait::size, pointee));
+}
+
+/// If @p lam is only executed when `iv <u x` holds, this function returns `x`.
+/// This is the case if @p lam is dominated by the `true`-successor of a branch on this condition within the loop of
+/// @p header. In particular, `iv + 1` can't wrap around then.
+Ref guard(const F_CFG& cfg, Lam* header, Lam* lam, Ref iv) {
+    const auto& domtree = cfg.domtree();
+    for (auto n = cfg[lam], h = cfg[header]; n && n != h;) {
+        auto idom = domtree.idom(n);
+        if (!idom || idom == n) return nullptr;
+
+        if (auto pred = idom->mut()->isa_mut<Lam>(); pred && cfg.num_preds(n) == 1) {
+            auto app     = pred->body() ? pred->body()->isa<App>() : nullptr;
+            auto extract = app ? app->callee()->isa<Extract>() : nullptr;
+            auto tuple   = extract ? extract->tuple()->isa<Tuple>() : nullptr;
+            if (tuple && tuple->num_ops() == 2 && tuple->op(1) == n->mut() && tuple->op(0) != n->mut()) {
+                if (auto cmp = match(core::icmp::ul, extract->index()); cmp && cmp->arg(0) == iv) return cmp->arg(1);
+                if (auto cmp = match(core::icmp::ug, extract->index()); cmp && cmp->arg(1) == iv) return cmp->arg(0);
+            }
+        }
+        n = idom;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void LoopOpt::visit(const Scope& scope) {
+    for (bool todo = true; todo;) {
+        todo = false;
+        // each transformation invalidates the CFG
+        Scope s(scope.entry());
+        auto heads = std::vector<const Head*>();
+        collect_heads(s.f_cfg().looptree().root(), heads);
+
+        for (auto head : heads) {
+            if (head->num_cf_nodes() != 1) continue; // irreducible
+            auto header = head->cf_nodes().front()->mut()->isa_mut<Lam>();
+            if (!header || !done_.emplace(header).second) continue;
+            if ((todo = optimize(s, head))) break;
+        }
+    }
+}
+
+bool LoopOpt::optimize(const Scope& scope, const Head* head) {
+    auto& w     = world();
+    auto& cfg   = scope.f_cfg();
+    auto header = head->cf_nodes().front()->mut()->as_mut<Lam>();
+    if (!header->is_set() || !Lam::isa_basicblock(header) || !header->type()->dep_const()) return false;
+
+    auto loop = LamSet();
+    collect_lams(head, loop);
+
+    // The header must only be called directly - either from outside of the loop or via a back-edge.
+    auto back_edges = std::vector<const App*>();
+    auto callers    = std::vector<Lam*>();
+    for (auto use : header->uses()) {
+        if (!scope.bound(use) || use->isa<Var>()) continue;
+        auto app = use->isa<App>();
+        if (!app || use.index() != 0) return false;
+
+        bool entry = false, back = false;
+        for (auto app_use : app->uses()) {
+            if (!scope.bound(app_use)) continue;
+            auto caller = app_use->isa_mut<Lam>();
+            if (!caller || app_use.index() != 1) return false;
+            (loop.contains(caller) ? back : entry) = true;
+            if (loop.contains(caller)) callers.emplace_back(caller);
+        }
+        if (entry && back) return false;
+        if (back) back_edges.emplace_back(app);
+    }
+    if (back_edges.empty() || back_edges.size() != callers.size()) return false;
+
+    // Header params that are passed on unchanged along all back-edges are loop-invariant.
+    auto n     = header->num_vars();
+    auto fixed = DefSet();
+    for (size_t i = 0; i != n; ++i) {
+        auto var = header->var(i);
+        if (std::ranges::all_of(back_edges, [&](const App* app) { return app->arg()->proj(n, i) == var; }))
+            fixed.emplace(var);
+    }
+
+    // Everything else that depends on a Var of a Lam of the loop is loop-variant.
+    auto bound = DefSet();
+    for (auto lam : loop) {
+        Scope lam_scope(lam);
+        bound.insert(lam_scope.bound().begin(), lam_scope.bound().end());
+    }
+    auto variant = DefMap<bool>();
+    auto is_variant = [&](Ref def, auto& self) -> bool {
+        if (!bound.contains(def) || fixed.contains(def)) return false;
+        if (auto i = variant.find(def); i != variant.end()) return i->second;
+        bool res = def->isa<Var>() || def->isa_mut()
+                || std::ranges::any_of(def->ops(), [&](Ref op) { return self(op, self); });
+        return variant[def] = res;
+    };
+    auto invariant = [&](Ref def) { return !is_variant(def, is_variant); };
+
+    // We will rewrite the Lam%s of the loop and everything nested in the header.
+    Scope header_scope(header);
+    auto lams = loop;
+    for (auto def : header_scope.bound()) {
+        if (auto mut = def->isa_mut()) {
+            auto lam = mut->isa<Lam>();
+            if (!lam || header_scope.bound(lam->type())) return false;
+            lams.emplace(lam);
+        }
+    }
+
+    // Look for memory effects, loads, and candidates for strength reduction.
+    bool writes   = false;
+    auto loads    = std::vector<const App*>();
+    auto products = std::vector<const Def*>();
+    auto users    = DefMap<LamSet>(); // Lam%s that evaluate a product
+    auto in_head  = DefSet();         // evaluated whenever the loop is entered
+    for (auto lam : lams) {
+        auto queue = unique_queue<DefSet>();
+        queue.push(lam->body());
+        while (!queue.empty()) {
+            auto def = queue.pop();
+            if (lam == header) in_head.emplace(def);
+
+            for (auto op : def->ops())
+                if (!op->isa_mut() && !invariant(op)) queue.push(op);
+
+            if (match<mem::lea>(def) || match(core::wrap::mul, def)) {
+                auto& lams = users[def];
+                if (lams.empty()) products.emplace_back(def);
+                lams.emplace(lam);
+            } else if (!loop.contains(lam)) {
+                continue;
+            } else if (auto load = match<mem::load>(def)) {
+                if (invariant(load->arg(1)) && std::ranges::find(loads, load) == loads.end()) loads.emplace_back(load);
+            } else if (auto app = def->isa<App>(); app && !Pi::isa_basicblock(app->callee_type())) {
+                if (has_mem(app->type()) || has_mem(app->arg()->type())) writes = true;
+            }
+        }
+    }
+
+    // Only hoist loads out of loops that don't write to memory and only if we may speculate them.
+    auto mem = mem_var(header), old_mem = mem;
+    if (writes || !mem) loads.clear();
+    std::erase_if(loads, [&](const App* load) { return !in_head.contains(load) && !dereferenceable(load->arg(1)); });
+
+    // Induction variables are incremented by a loop-invariant step along each back-edge.
+    auto ivs = std::vector<IV>();
+    for (size_t i = 0; i != n; ++i) {
+        auto var = header->var(i);
+        if (!Idx::size(var->type())) continue;
+
+        auto iv = IV{i, {}, true};
+        for (size_t k = 0, e = back_edges.size(); k != e; ++k) {
+            auto add = match(core::wrap::add, back_edges[k]->arg()->proj(n, i));
+            if (!add) break;
+            auto [a, b] = add->args<2>();
+            auto step   = a == var ? b : b == var ? a : nullptr;
+            if (!step || !invariant(step)) break;
+
+            auto mode = Lit::isa(add->decurry()->arg());
+            iv.no_wrap &= (mode && (*mode & core::Mode::nuw))
+                       || (Lit::isa(step) == 1 && guard(cfg, header, callers[k], var));
+            iv.steps.emplace_back(step);
+        }
+        if (iv.steps.size() == back_edges.size()) ivs.emplace_back(std::move(iv));
+    }
+
+    auto find_iv = [&](Ref def) -> std::optional<size_t> {
+        for (size_t j = 0, e = ivs.size(); j != e; ++j)
+            if (header->var(ivs[j].i) == def) return j;
+        return {};
+    };
+
+    // `iv * c` and `lea(ptr, iv)` with loop-invariant `c` and `ptr` are strength-reduced.
+    auto reduced = std::vector<Reduced>();
+    for (auto def : products) {
+        if (auto mul = match(core::wrap::mul, def)) {
+            auto [a, b] = mul->args<2>();
+            if (auto j = find_iv(a); j && invariant(b))
+                reduced.push_back({def, *j, b});
+            else if (auto j = find_iv(b); j && invariant(a))
+                reduced.push_back({def, *j, a});
+        } else if (auto lea = match<mem::lea>(def)) {
+            auto [ptr, index] = lea->args<2>();
+            auto [pointee, _] = force<Ptr>(ptr->type())->args<2>();
+            if (!invariant(ptr) || !pointee->isa<Arr>()) continue;
+
+            auto j = find_iv(index);
+            if (!j) {
+                // The index may also be a converted induction variable.
+                // If this conversion truncates, all users must be guarded by `iv <u x` with `x` in range.
+                Ref src = nullptr;
+                if (auto conv = match(core::conv::u, index)) src = conv->arg();
+                if (auto cast = match<core::bitcast>(index); cast && Idx::size(cast->arg()->type())) src = cast->arg();
+                if (!src || !(j = find_iv(src))) continue;
+
+                if (!widens(src->type(), index->type())) {
+                    auto size = Lit::isa(Idx::size(index->type()));
+                    if (!size || !std::ranges::all_of(users[def], [&](Lam* lam) {
+                            auto x = guard(cfg, header, lam, src);
+                            auto l = x ? Lit::isa(x) : std::nullopt;
+                            return l && (*size == 0 || *l <= *size);
+                        }))
+                        continue;
+                }
+            }
+            if (ivs[*j].no_wrap) reduced.push_back({def, *j, nullptr});
+        }
+    }
+
+    if (loads.empty() && reduced.empty()) return false;
+    w.DLOG("loop_opt: {} in {} - hoisting {} loads, reducing {} defs", header, scope.entry(), loads.size(),
+           reduced.size());
+
+    // build new header
+    auto doms = DefVec();
+    for (size_t i = 0; i != n; ++i) doms.emplace_back(header->var(i)->type());
+    for (auto load : loads) doms.emplace_back(load->type()->as<Sigma>()->op(1));
+    for (const auto& r : reduced) doms.emplace_back(r.def->type());
+    auto new_header = w.mut_lam(w.cn(doms))->set(header->dbg());
+    done_.emplace(new_header);
+
+    LoopRewriter rewriter(w, new_header, n);
+    if (n == 1) {
+        rewriter.map(header->var(), new_header->var(0));
+    } else {
+        rewriter.map(header->var(), w.tuple(DefArray(n, [&](size_t i) { return new_header->var(i); })));
+    }
+
+    // preheader arguments
+    auto args = DefVec();
+    for (size_t i = 0; i != n; ++i) args.emplace_back(header->var(i));
+    for (size_t k = 0, e = loads.size(); k != e; ++k) {
+        auto load = w.app(loads[k]->callee(), {mem, loads[k]->arg(1)});
+        mem       = load->proj(2, 0);
+        args.emplace_back(load->proj(2, 1));
+        rewriter.loads_[loads[k]] = new_header->var(n + k);
+    }
+    for (size_t i = 0; i != n; ++i)
+        if (header->var(i) == old_mem) args[i] = mem;
+    for (size_t j = 0, e = reduced.size(); j != e; ++j) {
+        args.emplace_back(reduced[j].def);
+        rewriter.map(reduced[j].def, new_header->var(n + loads.size() + j));
+    }
+
+    // back-edge arguments
+    for (size_t k = 0, e = back_edges.size(); k != e; ++k) {
+        auto& extra = rewriter.back_edges_[back_edges[k]];
+        for (size_t l = 0, e = loads.size(); l != e; ++l) extra.emplace_back(new_header->var(n + l));
+        for (size_t j = 0, e = reduced.size(); j != e; ++j) {
+            auto [def, iv, factor] = reduced[j];
+            auto q                 = new_header->var(n + loads.size() + j);
+            auto step              = ivs[iv].steps[k];
+            if (factor) {
+                auto inc = w.call(core::wrap::mul, 0_n, Defs{step, factor});
+                extra.emplace_back(w.call(core::wrap::add, 0_n, Defs{q, inc}));
+            } else {
+                auto [pointee, addr_space] = force<Ptr>(def->type())->args<2>();
+                auto arr                   = w.call<Ptr>(Defs{w.arr(w.top_nat(), pointee), addr_space});
+                extra.emplace_back(op_lea_unsafe(w.call<core::bitcast>(arr, q), step));
+            }
+        }
+    }
+
+    new_header->set(rewriter.rewrite(header->filter()), rewriter.rewrite(header->body()));
+    for (auto lam : lams)
+        if (lam != header) lam->reset({rewriter.rewrite(lam->filter()), rewriter.rewrite(lam->body())});
+    header->reset({w.lit_ff(), w.app(new_header, args)});
+
+    return true;
+}
+
+} // namespace thorin::mem
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "thorin/analyses/looptree.h"
+#include "thorin/phase/phase.h"
+
+namespace thorin::mem {
+
+/// Classic loop optimizations on top of the LoopTree and DomTree of each top-level Scope.
+/// Pure loop-invariant computations don't need any treatment here: they float and Scheduler::smart already places
+/// them outside of loops. Instead, for each loop with a single header `H` that is only called directly, this phase
+/// * hoists loop-invariant `%%mem.load`s, if the loop doesn't write to memory and the load is safe to speculate, and
+/// * strength-reduces `%%core.wrap.mul`s and `%%mem.lea`s of an induction variable into incremental updates.
+///
+/// The old header becomes the preheader that jumps to a new header `H'`, which receives the hoisted values as
+/// additional arguments:
+/// ```
+/// H(vars) = ...      ↦   H(vars)         = H'(vars, loads, reduced)
+///                        H'(vars', v, q) = ...
+/// back-edge H(args)  ↦   back-edge H'(args, v, bump(q))
+/// ```
+class LoopOpt : public ScopePhase {
+public:
+    LoopOpt(World& world)
+        : ScopePhase(world, "loop_opt", true) {
+        dirty_ = true;
+    }
+
+    void visit(const Scope&) override;
+
+private:
+    bool optimize(const Scope&, const LoopTree<true>::Head*);
+
+    LamSet done_; ///< Loop headers we have already looked at.
+};
+
+} // namespace thorin::mem
@@ -1,4 +1,7 @@
 #include "thorin/check.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 
 #include "thorin/world.h"
 
@@ -46,6 +49,42 @@ const Def* Infer::find(const Def* def) {
  * Check
  */
 
+template<class F> bool Check::run(World& world, F f) {
+    static double total = 0; static bool reg = false;
+    if (!reg) { reg = true; if (getenv("THORIN_CHECK_TIME")) std::atexit([] { std::fprintf(stderr, "CHECKTIME %f\n", total); }); }
+    static bool nocache = getenv("THORIN_NO_CHECK_CACHE");
+    if (nocache) { auto t0 = std::chrono::steady_clock::now(); Check fresh; auto r = f(fresh); if (!world.check_.busy) total += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count(); return r; }
+    if (world.check_.busy) {
+        Check fresh;
+        return f(fresh);
+    }
+
+    struct Lease {
+        Lease(World& world)
+            : busy(world.check_.busy) {
+            busy = true;
+        }
+        ~Lease() { busy = false; }
+        bool& busy;
+    } lease(world);
+
+    auto& check = world.check_.check;
+    check.vars_.clear();
+    check.done_.clear();
+    auto t0 = std::chrono::steady_clock::now();
+    auto r = f(check);
+    total += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+template<bool infer> bool Check::alpha(Ref d1, Ref d2) {
+    return run(d1->world(), [&](Check& check) { return check.alpha_<infer>(d1, d2); });
+}
+
+bool Check::assignable(Ref type, Ref value) {
+    return run(type->world(), [&](Check& check) { return check.assignable_(type, value); });
+}
+
 template<bool infer> bool Check::alpha_(Ref r1, Ref r2) {
     auto d1 = *r1; // find
     auto d2 = *r2; // find
@@ -90,7 +129,14 @@ template<bool infer> bool Check::alpha_(Ref r1, Ref r2) {
         || (d1->gid() > d2->gid()))              // smaller gid to left
         std::swap(d1, d2);
 
-    return alpha_internal<infer>(d1, d2);
+    // Closed immutables never change: remember what we have already proven.
+    bool closed  = !d1->has_dep(Dep::Mut | Dep::Var | Dep::Infer) && !d2->has_dep(Dep::Mut | Dep::Var | Dep::Infer);
+    auto& proven = d1->world().move_.alpha[infer];
+    if (closed && proven.contains({d1, d2})) return true;
+
+    if (!alpha_internal<infer>(d1, d2)) return false;
+    if (closed) proven.emplace(d1, d2);
+    return true;
 }
 
 template<bool infer> bool Check::alpha_internal(Ref d1, Ref d2) {
@@ -103,6 +149,10 @@ template<bool infer> bool Check::alpha_internal(Ref d1, Ref d2) {
     if (auto mut1 = d1->isa_mut()) assert_emplace(vars_, mut1, d2->isa_mut());
     if (auto mut2 = d2->isa_mut()) assert_emplace(vars_, mut2, d1->isa_mut());
 
+    // Neither expand uniform Pack%s/Arr%ays nor walk their elements via Def::proj.
+    if ((d1->isa<Tuple, Sigma>() || d1->isa<Insert>()) && (d2->isa_imm<Pack>() || d2->isa_imm<Arr>()))
+        std::swap(d1, d2);
+
     if (auto ts = d1->isa<Tuple, Sigma>()) {
         size_t a = ts->num_ops();
         for (size_t i = 0; i != a; ++i)
@@ -110,6 +160,14 @@ template<bool infer> bool Check::alpha_internal(Ref d1, Ref d2) {
         return true;
     } else if (auto pa = d1->isa<Pack, Arr>()) {
         if (pa->node() == d2->node()) return alpha_<infer>(pa->ops().back(), d2->ops().back());
+        if (pa->isa_imm()) {
+            auto body = pa->ops().back();
+            // ‹n; x› vs (x, y, x, y, ...): only compare distinct elements
+            if (auto ts = d2->isa<Tuple, Sigma>()) return alpha_each<infer>(ts->ops(), body);
+            // ‹n; x› vs insert(t, i, y) => ‹n; x› vs t and x vs y
+            if (auto insert = d2->isa<Insert>(); insert && Lit::isa(insert->index()))
+                return alpha_<infer>(body, insert->value()) && alpha_<infer>(pa, insert->tuple());
+        }
         if (auto a = pa->isa_lit_arity()) {
             for (size_t i = 0; i != *a; ++i)
                 if (!alpha_<infer>(pa->proj(*a, i), d2->proj(*a, i))) return false;
@@ -137,10 +195,22 @@ template<bool infer> bool Check::alpha_internal(Ref d1, Ref d2) {
     return true;
 }
 
+template<bool infer> bool Check::alpha_each(Defs ops, Ref elem) {
+    auto seen = DefSet();
+    for (auto op : ops)
+        if (seen.emplace(op).second && !alpha_<infer>(op, elem)) return false;
+    return true;
+}
+
 bool Check::assignable_(Ref type, Ref val) {
     auto val_ty = Ref::refer(val->type());
     if (type == val_ty) return true;
 
+    // For closed types, α-equivalence - which memoizes its verdicts - already implies assignability.
+    if (!type->has_dep(Dep::Mut | Dep::Var | Dep::Infer) && !val_ty->has_dep(Dep::Mut | Dep::Var | Dep::Infer)
+        && !getenv("THORIN_NO_CHECK_CACHE") && alpha_<true>(type, val_ty))
+        return true;
+
     if (auto infer = val->isa_mut<Infer>()) return alpha_<true>(type, infer->type());
 
     if (auto sigma = type->isa<Sigma>()) {
@@ -154,7 +224,16 @@ bool Check::assignable_(Ref type, Ref val) {
     } else if (auto arr = type->isa<Arr>()) {
         if (!alpha_<true>(type->arity(), val_ty->arity())) return false;
 
-        if (auto a = Lit::isa(arr->arity())) {
+        if (arr->isa_imm()) {
+            // uniform element type: check each distinct element once - or the whole type, if val is opaque
+            if (auto pack = val->isa_imm<Pack>()) return assignable_(arr->body(), pack->body());
+            if (auto tuple = val->isa<Tuple>()) {
+                auto seen = DefSet();
+                for (auto op : tuple->ops())
+                    if (seen.emplace(op).second && !assignable_(arr->body(), op)) return false;
+                return true;
+            }
+        } else if (auto a = Lit::isa(arr->arity())) {
             for (size_t i = 0; i != *a; ++i)
                 if (!assignable_(arr->proj(*a, i), val->proj(*a, i))) return false;
             return true;
@@ -166,6 +245,9 @@ bool Check::assignable_(Ref type, Ref val) {
     return alpha_<true>(type, val_ty);
 }
 
+template bool Check::alpha<true>(Ref, Ref);
+template bool Check::alpha<false>(Ref, Ref);
+
 Ref Check::is_uniform(Defs defs) {
     if (defs.empty()) return nullptr;
     auto first = defs.front();
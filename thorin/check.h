@@ -48,18 +48,22 @@ public:
     ///     Also, two *free* but *different* Var%s **are** considered α-equivalent.
     /// * When **not* in @p infer mode, no type inference is happening and Infer%s will not be touched.
     ///     Also, Two *free* but *different* Var%s are **not** considered α-equivalent.
-    template<bool infer = true> static bool alpha(Ref d1, Ref d2) { return Check().alpha_<infer>(d1, d2); }
+    template<bool infer = true> static bool alpha(Ref d1, Ref d2);
 
     /// Can @p value be assigned to sth of @p type?
     /// @note This is different from `equiv(type, value->type())` since @p type may be dependent.
-    static bool assignable(Ref type, Ref value) { return Check().assignable_(type, value); }
+    static bool assignable(Ref type, Ref value);
 
     /// Yields `defs.front()`, if all @p defs are Check::alpha-equivalent (`infer = false`) and `nullptr` otherwise.
     static Ref is_uniform(Defs defs);
 
 private:
+    /// Runs @p f on the World's Check whose maps are merely cleared - or on a fresh one, if a check is already running.
+    template<class F> static bool run(World&, F f);
     template<bool infer> bool alpha_(Ref d1, Ref d2);
     template<bool infer> bool alpha_internal(Ref, Ref);
+    /// Is each of @p ops α-equivalent to @p elem? Checks each *distinct* op only once.
+    template<bool infer> bool alpha_each(Defs ops, Ref elem);
     bool assignable_(Ref type, Ref value);
 
     using Vars = MutMap<Def*>;
@@ -10,7 +10,6 @@ struct Flags {
     bool dump_recursive        = false;
     bool disable_type_checking = false; // TODO implement this flag
     bool bootstrap             = false;
-    bool aggressive_lam_spec   = false; // HACK makes LamSpec more agressive but potentially non-terminating
 #ifdef THORIN_ENABLE_CHECKS
     bool reeval_breakpoints = false;
     bool trace_gids         = false;
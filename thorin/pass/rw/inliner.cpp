@@ -0,0 +1,53 @@
+#include "thorin/pass/rw/inliner.h"
+
+#include "thorin/analyses/scope.h"
+
+namespace thorin {
+
+Ref Inliner::rewrite(Ref def) {
+    auto [app, lam] = isa_apped_mut_lam(def);
+    if (!isa_workable(lam) || !Lam::isa_returning(lam) || lam == curr_mut()) return def;
+
+    const auto& cost = this->cost(lam);
+    if (!cost.leaf) return def;
+
+    size_t bonus = 0;
+    for (size_t i = 0, n = lam->num_vars(); i != n; ++i)
+        if (app->arg(n, i)->isa<Lit>()) bonus += Lit_Bonus * cost.num_uses[i];
+    if (cost.size > Threshold + bonus) return def;
+
+    auto& growth = growth_[curr_mut()];
+    if (growth + cost.size > Caller_Budget || module_growth_ + cost.size > Module_Budget) return def;
+    growth += cost.size;
+    module_growth_ += cost.size;
+
+    world().DLOG("inline '{}' (size: {}, bonus: {}) into '{}'", lam, cost.size, bonus, curr_mut());
+    return lam->reduce(app->arg()).back();
+}
+
+/// The Cost of @p lam is computed once - as soon as we see @p lam the first time in callee position.
+/// Only leaf functions - i.e. functions that don't call other functions but only basic blocks - are considered.
+/// This rules out (mutual) recursion which would otherwise be unrolled until the budget is exhausted.
+const Inliner::Cost& Inliner::cost(Lam* lam) {
+    if (auto i = lam2cost_.find(lam); i != lam2cost_.end()) return i->second;
+
+    Scope scope(lam);
+    auto n = lam->num_vars();
+    Cost cost{true, scope.bound().size(), std::vector<size_t>(n)};
+
+    for (auto def : scope.bound()) {
+        if (auto app = def->isa<App>(); app && Lam::isa_mut_returning(app->callee())) {
+            cost.leaf = false;
+            break;
+        }
+    }
+
+    for (size_t i = 0; i != n; ++i) {
+        for (auto use : lam->var(n, i)->uses())
+            if (scope.bound(use)) ++cost.num_uses[i];
+    }
+
+    return lam2cost_[lam] = std::move(cost);
+}
+
+} // namespace thorin
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "thorin/pass/pass.h"
+
+namespace thorin {
+
+/// Inlines calls to small leaf functions - at **each** call site.
+/// In contrast to BetaRed, which only inlines functions that occur exactly once, this pass relies on a cost model:
+/// A callee is inlined if its size - the number of Def%s in its Scope - does not exceed Threshold plus a bonus for each
+/// use of a parameter that receives a literal argument and, hence, is likely to be constant-folded by normalizers.
+/// The code growth is limited per caller as well as for the whole PassMan run.
+class Inliner : public RWPass<Inliner, Lam> {
+public:
+    /// @name Cost Model
+    ///@{
+    static constexpr size_t Threshold     = 32;   ///< Largest callee to be inlined without any bonus.
+    static constexpr size_t Lit_Bonus     = 8;    ///< Bonus per use of a parameter that receives a literal.
+    static constexpr size_t Caller_Budget = 256;  ///< Max code growth of a single caller.
+    static constexpr size_t Module_Budget = 4096; ///< Max code growth of the whole World.
+    ///@}
+
+    Inliner(PassMan& man)
+        : RWPass(man, "inliner") {}
+
+private:
+    struct Cost {
+        bool leaf; ///< Does not call other functions?
+        size_t size;
+        std::vector<size_t> num_uses; ///< Number of uses of each parameter.
+    };
+
+    /// @name PassMan hooks
+    ///@{
+    Ref rewrite(Ref) override;
+    ///@}
+
+    const Cost& cost(Lam*);
+
+    LamMap<Cost> lam2cost_;
+    LamMap<size_t> growth_;
+    size_t module_growth_ = 0;
+};
+
+} // namespace thorin
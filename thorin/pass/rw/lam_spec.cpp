@@ -5,8 +5,6 @@
 #include "thorin/pass/fp/eta_exp.h"
 #include "thorin/util/util.h"
 
-// TODO This is supposed to recreate what lower2cff did, but we should really consider another strategy and nuke this.
-
 namespace thorin {
 
 namespace {
@@ -36,45 +34,98 @@ Ref LamSpec::rewrite(Ref def) {
     if (auto i = old2new_.find(def); i != old2new_.end()) return i->second;
 
     auto [app, old_lam] = isa_apped_mut_lam(def);
-    if (!isa_workable(old_lam)) return def;
+    if (!isa_workable(old_lam) || old_lam->dom()->isa_mut()) return def;
+
+    const auto& info = this->info(old_lam);
+    auto lits        = !info.rec && Lam::isa_returning(old_lam);
+    auto skip        = old_lam->ret_var() && info.top;
+    bool known = false, lit = false;
+
+    auto n    = old_lam->num_vars();
+    auto sigs = DefArray(n, [&](size_t i) {
+        auto dom = old_lam->dom(n, i);
+        return skip && i == n - 1 ? world().top(dom) : abstract(app->arg(n, i), dom, lits, known, lit);
+    });
+    if (!known) return def;
+
+    auto sig    = n == 1 ? Ref(sigs.front()) : world().tuple(old_lam->dom(), sigs);
+    auto& clone = lam2clones_[old_lam][sig];
+    auto doms   = DefVec();
+    auto args   = DefVec();
+    split(sig, app->arg(), doms, args);
+
+    if (!clone) {
+        if (info.rec || lit) {
+            auto& num = num_clones_[old_lam];
+            if (num == Max_Clones || growth_ + info.size > Budget) return def;
+            ++num;
+            growth_ += info.size;
+        }
+
+        clone  = old_lam->stub(world(), world().cn(world().sigma(doms)));
+        auto i = size_t(0);
+        clone->set(old_lam->reduce(inst(sig, app->arg(), clone, doms.size(), i)));
+        world().DLOG("{} -> {}: {} -> {})", old_lam, clone, old_lam->dom(), clone->dom());
+    }
 
-    // Skip recursion to avoid infinite inlining if not "aggressive_lam_spec".
-    // This is a hack - but we want to get rid off this Pass anyway.
-    Scope scope(old_lam);
-    if (!world().flags().aggressive_lam_spec && scope.free_defs().contains(old_lam)) return def;
+    return old2new_[def] = world().app(clone, args);
+}
 
-    DefVec new_doms, new_vars, new_args;
-    auto skip     = old_lam->ret_var() && is_top_level(old_lam);
-    auto old_doms = old_lam->doms();
+/// Computes the signature of @p arg, i.e. replaces all unknown parts of @p arg by ⊤.
+/// Closed constants only count as known if @p lits permits it.
+Ref LamSpec::abstract(Ref arg, Ref type, bool lits, bool& known, bool& lit) {
+    if (type->isa<Pi>()) {
+        known = true;
+        return arg;
+    }
+    if (lits && arg->dep_const()) {
+        known = lit = true;
+        return arg;
+    }
 
-    for (auto dom : old_doms.skip_back(skip))
-        if (!dom->isa<Pi>()) new_doms.emplace_back(dom);
+    if (auto tuple = arg->isa<Tuple>(); tuple && !type->isa_mut()) {
+        bool any = false;
+        auto n   = tuple->num_ops();
+        auto ops = DefArray(n, [&](size_t i) { return abstract(tuple->op(i), type->proj(n, i), lits, any, lit); });
+        if (any) {
+            known = true;
+            return world().tuple(type, ops);
+        }
+    }
 
-    if (skip) new_doms.emplace_back(old_lam->doms().back());
-    if (new_doms.size() == old_lam->num_doms()) return def;
+    return world().top(type);
+}
 
-    auto new_pi  = world().cn(world().sigma(new_doms));
-    auto new_lam = old_lam->stub(world(), new_pi);
+/// Collects types and arguments of the parts of @p arg that are unknown according to @p sig.
+void LamSpec::split(Ref sig, Ref arg, DefVec& doms, DefVec& args) {
+    if (sig == arg) return;
 
-    for (size_t arg_i = 0, var_i = 0, n = app->num_args() - skip; arg_i != n; ++arg_i) {
-        auto arg = app->arg(arg_i);
-        if (old_lam->dom(arg_i)->isa<Pi>()) {
-            new_vars.emplace_back(arg);
-        } else {
-            new_vars.emplace_back(new_lam->var(var_i++));
-            new_args.emplace_back(arg);
-        }
+    if (auto tuple = sig->isa<Tuple>()) {
+        for (size_t i = 0, n = tuple->num_ops(); i != n; ++i) split(tuple->op(i), arg->proj(n, i), doms, args);
+    } else {
+        doms.emplace_back(sig->type());
+        args.emplace_back(arg);
     }
+}
 
-    if (skip) {
-        new_vars.emplace_back(new_lam->vars().back());
-        new_args.emplace_back(app->args().back());
+/// Rebuilds @p arg for the @p clone: The unknown parts are replaced by the Lam::var%s of @p clone.
+Ref LamSpec::inst(Ref sig, Ref arg, Lam* clone, size_t num_doms, size_t& i) {
+    if (sig == arg) return arg;
+
+    if (auto tuple = sig->isa<Tuple>()) {
+        auto n = tuple->num_ops();
+        auto ops = DefArray(n, [&](size_t j) { return inst(tuple->op(j), arg->proj(n, j), clone, num_doms, i); });
+        return world().tuple(sig->type(), ops);
     }
 
-    new_lam->set(old_lam->reduce(world().tuple(new_vars)));
-    world().DLOG("{} -> {}: {} -> {})", old_lam, new_lam, old_lam->dom(), new_lam->dom());
+    return clone->var(num_doms, i++);
+}
+
+const LamSpec::Info& LamSpec::info(Lam* lam) {
+    if (auto i = lam2info_.find(lam); i != lam2info_.end()) return i->second;
 
-    return old2new_[def] = world().app(new_lam, new_args);
+    Scope scope(lam);
+    return lam2info_[lam] = {scope.free_defs().contains(lam), is_top_level(lam), scope.bound().size()};
 }
 
 } // namespace thorin
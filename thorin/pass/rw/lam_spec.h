@@ -4,18 +4,47 @@
 
 namespace thorin {
 
+/// Specializes callees for the *known* parts of their arguments by cloning them:
+/// * Higher-order arguments - i.e. arguments of Pi type - are always known; this recreates what `lower2cff` did.
+///   The return continuation of a top-level function is kept, though.
+/// * Closed constants (Lit%s, types, ...) are known if the callee is a non-recursive, returning function.
+/// * Tuple%s are taken apart: Only their known elements are specialized; the others become separate parameters.
+///
+/// Clones are cached by their *signature* - the argument with each unknown part replaced by ⊤.
+/// Hence, all call sites that pass the same known values share a clone; in particular, a recursive call that
+/// passes on the very same continuation is closed by the cache.
+/// Specializing non-recursive callees for higher-order arguments terminates on its own.
+/// All other specializations are bounded by Max_Clones per callee and by Budget for the whole PassMan run.
 class LamSpec : public RWPass<LamSpec, Lam> {
 public:
+    static constexpr size_t Max_Clones = 8;    ///< Max number of budgeted clones of a single Lam.
+    static constexpr size_t Budget     = 8192; ///< Max code growth of all budgeted clones.
+
     LamSpec(PassMan& man)
         : RWPass(man, "lam_spec") {}
 
 private:
+    struct Info {
+        bool rec;    ///< Does the Lam occur in its own Scope?
+        bool top;    ///< Is the Lam top-level?
+        size_t size; ///< Number of Def%s in its Scope.
+    };
+
     /// @name PassMan hooks
     ///@{
     Ref rewrite(Ref) override;
     ///@}
 
+    const Info& info(Lam*);
+    Ref abstract(Ref arg, Ref type, bool lits, bool& known, bool& lit);
+    void split(Ref sig, Ref arg, DefVec& doms, DefVec& args);
+    Ref inst(Ref sig, Ref arg, Lam* clone, size_t num_doms, size_t& i);
+
     Def2Def old2new_;
+    LamMap<Info> lam2info_;
+    LamMap<DefMap<Lam*>> lam2clones_; ///< Signature ↦ clone.
+    LamMap<size_t> num_clones_;
+    size_t growth_ = 0;
 };
 
 } // namespace thorin
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <bit>
+
+#include "thorin/world.h"
+
+/// Declarative peephole rewrites for normalizers.
+/// A Rule consists of a *pattern*, a *replacement*, and an optional *guard* - all of them are types:
+/// ```
+/// // c0 + (c1 + x) -> (c0 + c1) + x
+/// Rule<Op<wrap::add, Const<0>, Op<wrap::add, Const<1>, Any<2>>>,
+///      Op<wrap::add, Op<wrap::add, Const<0>, Const<1>>, Any<2>>>
+/// ```
+/// Normalizers are already registered per sub tag.
+/// For this reason, the root of a pattern doesn't have to be tested: Only its two operands are matched.
+/// A Rules set is instantiated at compile time into a sequence of nested tests - there is no interpretation at runtime.
+/// In the common case that nothing matches, this boils down to a few Axiom::get%s per rule.
+/// Replacements are built via World::call and, hence, normalized again.
+/// In particular, `Op<wrap::add, Const<0>, Const<1>>` from above is folded right away.
+namespace thorin::rule {
+
+/// Variables bound while matching and everything else needed to build the replacement.
+class Env {
+public:
+    static constexpr size_t Max_Vars = 4;
+
+    /// @p mode is the mode of the root and will be used for all new Op%s; `0` if the root doesn't have one.
+    Env(Ref type, nat_t mode = 0)
+        : type_(type)
+        , mode_(mode) {}
+
+    World& world() const { return type_->world(); }
+    Ref type() const { return type_; }
+    Ref operator[](size_t i) const { return vars_[i]; }
+    u64 lit(size_t i) const { return Lit::as(vars_[i]); }
+
+    /// Least upper bound of the modes of all matched Op%s - or rather the mode of the root for new ones.
+    nat_t mode() const { return mode_; }
+    void meet(Ref mode) { mode_ &= Lit::isa(mode).value_or(0); }
+
+    /// Binds variable @p i to @p def - or checks that @p i has already been bound to @p def.
+    bool bind(size_t i, Ref def) {
+        assert(i < Max_Vars);
+        if (vars_[i]) return vars_[i] == def;
+        vars_[i] = def;
+        return true;
+    }
+
+private:
+    Ref type_;
+    nat_t mode_;
+    std::array<Ref, Max_Vars> vars_ = {};
+};
+
+/// @name Patterns
+/// Patterns provide `static bool match(Env&, Ref)`; most of them are also replacements.
+///@{
+
+/// Matches anything.
+template<size_t I>
+struct Any {
+    static bool match(Env& env, Ref def) { return env.bind(I, def); }
+    static Ref build(const Env& env) { return env[I]; }
+};
+
+/// Matches a Lit.
+template<size_t I>
+struct Const {
+    static bool match(Env& env, Ref def) { return def->isa<Lit>() && env.bind(I, def); }
+    static Ref build(const Env& env) { return env[I]; }
+};
+
+/// Matches a Lit that is a power of two.
+template<size_t I>
+struct Pow2 {
+    static bool match(Env& env, Ref def) {
+        auto l = Lit::isa(def);
+        return l && std::has_single_bit(*l) && env.bind(I, def);
+    }
+    static Ref build(const Env& env) { return env[I]; }
+};
+
+/// Matches/builds the binary operation @p Id.
+/// If @p Id has a curried mode in front of its operands, the modes of all matched Op%s are Env::meet'ed.
+template<auto Id, class A, class B>
+struct Op {
+    /// Matches the operands of the root.
+    static bool match(Env& env, Ref a, Ref b) { return A::match(env, a) && B::match(env, b); }
+
+    static bool match(Env& env, Ref def) {
+        auto op = thorin::match(Id, def);
+        if (!op) return false;
+        if (has_mode(env.world())) env.meet(op->decurry()->arg());
+        auto [a, b] = op->template args<2>();
+        return match(env, a, b);
+    }
+
+    static Ref build(const Env& env) {
+        auto& w = env.world();
+        auto a  = A::build(env);
+        auto b  = B::build(env);
+        return has_mode(w) ? w.call(Id, env.mode(), Defs{a, b}) : w.call(Id, Defs{a, b});
+    }
+
+private:
+    static bool has_mode(World& w) { return w.annex(Id)->template as<Axiom>()->curry() == 3; }
+};
+///@}
+
+/// @name Replacements
+/// Replacements provide `static Ref build(const Env&)`.
+///@{
+
+/// `log2` of the power of two bound to @p I.
+template<size_t I>
+struct Log2 {
+    static Ref build(const Env& env) { return env.world().lit(env[I]->type(), std::countr_zero(env.lit(I))); }
+};
+
+/// Lit bound to @p I minus one.
+template<size_t I>
+struct Dec {
+    static Ref build(const Env& env) { return env.world().lit(env[I]->type(), env.lit(I) - 1); }
+};
+
+/// Sum of the Lit%s bound to @p I and @p J; a guard must rule out wrap around.
+template<size_t I, size_t J>
+struct Sum {
+    static Ref build(const Env& env) { return env.world().lit(env[I]->type(), env.lit(I) + env.lit(J)); }
+};
+///@}
+
+/// @name Rules
+///@{
+struct Always {
+    static bool check(const Env&) { return true; }
+};
+
+/// Requires @p M in the Env::mode of all matched Op%s.
+template<auto M>
+struct Has {
+    static bool check(const Env& env) { return (env.mode() & nat_t(M)) == nat_t(M); }
+};
+
+template<class Pattern, class Replacement, class Guard = Always>
+struct Rule {
+    /// Every Rule starts with a fresh copy of @p env.
+    static Ref apply(Env env, Ref a, Ref b) {
+        if (Pattern::match(env, a, b) && Guard::check(env)) return Replacement::build(env);
+        return nullptr;
+    }
+};
+
+/// Tries all rules in order.
+/// @returns the replacement of the first Rule that matches or `nullptr`.
+template<class... R>
+struct Rules {
+    static Ref apply(const Env& env, Ref a, Ref b) {
+        Ref res;
+        ((res = R::apply(env, a, b)) || ...);
+        return res;
+    }
+};
+///@}
+
+} // namespace thorin::rule
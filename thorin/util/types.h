@@ -2,7 +2,10 @@
 
 #include <cstdint>
 
+#include <array>
+#include <bit>
 #include <limits>
+#include <optional>
 #include <ostream>
 #include <type_traits>
 
@@ -75,6 +78,29 @@ template<int w> using w2s = typename detail::w2s_<w>::type;
 template<int w> using w2f = typename detail::w2f_<w>::type;
 ///@}
 
+/// @name Width Tables
+/// Constant folders are instantiated for each bit width in THORIN_1_8_16_32_64.
+/// A width table holds these instantiations such that folding a literal boils down to a single indirect call instead of
+/// `switch`ing over the width.
+///@{
+static constexpr size_t Num_Widths = 5;
+
+/// Index of @p w within `1, 8, 16, 32, 64` or `std::nullopt`.
+constexpr std::optional<size_t> width2index(nat_t w) {
+    if (w == 1) return 0;
+    if (w < 8 || w > 64 || !std::has_single_bit(w)) return {};
+    return std::countr_zero(w) - 2;
+}
+
+/// Yields `{gen.operator()<1>(), gen.operator()<8>(), ..., gen.operator()<64>()}`.
+template<class T, class Gen>
+constexpr std::array<T, Num_Widths> width_table(Gen gen) {
+#define CODE5(i) gen.template operator()<i>(),
+    return {THORIN_1_8_16_32_64(CODE5)};
+#undef CODE5
+}
+///@}
+
 /// @name User-Defined Literals
 ///@{
 #define CODE4(i)                                                                        \
@@ -23,6 +23,9 @@
 namespace thorin {
 
 namespace {
+/// Packs of larger literal arity stay a Pack with a chain of Insert%s on top instead of being expanded to a Tuple.
+constexpr nat_t Expand_Pack_Threshold = 64;
+
 bool is_shape(Ref s) {
     if (s->isa<Nat>()) return true;
     if (auto arr = s->isa<Arr>()) return arr->body()->isa<Nat>();
@@ -377,16 +380,23 @@ Ref World::insert(Ref d, Ref index, Ref val) {
 
     // insert(‹4; x›, 2, y) -> (x, x, y, x)
     if (auto pack = d->isa<Pack>()) {
-        if (auto a = pack->isa_lit_arity()) {
+        if (auto a = pack->isa_lit_arity(); a && *a <= Expand_Pack_Threshold) {
             DefArray new_ops(*a, pack->body());
             new_ops[Lit::as(index)] = val;
             return tuple(type, new_ops);
         }
     }
 
-    // insert(insert(x, index, y), index, val) -> insert(x, index, val)
     if (auto insert = d->isa<Insert>()) {
-        if (insert->index() == index) d = insert->tuple();
+        // insert(insert(x, index, y), index, val) -> insert(x, index, val)
+        if (insert->index() == index) return this->insert(insert->tuple(), index, val);
+
+        // Keep literal indices sorted - innermost first - so each set of overrides has a unique representation:
+        // insert(insert(x, 3, y), 1, val) -> insert(insert(x, 1, val), 3, y)
+        if (auto i = Lit::isa(index)) {
+            if (auto j = Lit::isa(insert->index()); j && *i < *j)
+                return this->insert(this->insert(insert->tuple(), index, val), insert->index(), insert->value());
+        }
     }
 
     return unify<Insert>(3, d, index, val);
@@ -453,7 +463,7 @@ Ref World::pack(Defs shape, Ref body) {
 const Lit* World::lit(Ref type, u64 val) {
     if (auto size = Idx::size(type)) {
         if (auto s = Lit::isa(size)) {
-            if (*s != 0 && val >= *s) error(type, "index '{}' does not fit within arity '{}'", size, val);
+            if (*s != 0 && val >= *s) error(type, "index '{}' does not fit within arity '{}'", val, size);
         } else if (val != 0) { // 0 of any size is allowed
             error(type, "cannot create literal '{}' of '.Idx {}' as size is unknown", val, size);
         }
@@ -582,6 +582,7 @@ private:
         absl::btree_map<Sym, Def*> externals;
         absl::flat_hash_set<const Def*, SeaHash, SeaEq> defs;
         DefDefMap<DefArray> cache;
+        std::array<DefDefSet, 2> alpha; ///< Closed Def%s already proven Check::alpha-equivalent - per `infer` mode.
 
         friend void swap(Move& m1, Move& m2) {
             using std::swap;
@@ -590,10 +591,16 @@ private:
             swap(m1.externals, m2.externals);
             swap(m1.defs,      m2.defs);
             swap(m1.cache,     m2.cache);
+            swap(m1.alpha,     m2.alpha);
             // clang-format on
         }
     } move_;
 
+    struct {
+        Check check; ///< Reused by Check::alpha and Check::assignable.
+        bool busy = false;
+    } check_;
+
     struct {
         const Univ* univ;
         const Type* type_0;
@@ -631,6 +638,7 @@ private:
         assert(&w2.univ()->world() == &w2);
     }
 
+    friend class Check;
     friend DefArray Def::reduce(const Def*);
 };
 